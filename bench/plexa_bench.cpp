@@ -0,0 +1,320 @@
+#include "executor.h"
+#include "message_writer.h"
+#include "binary_writer.h"
+#include <chrono>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    using bench_clock = std::chrono::steady_clock;
+
+    struct samples
+    {
+        void add(const bench_clock::duration &d) { durations.push_back(std::chrono::duration<double, std::micro>(d).count()); }
+
+        std::string to_json() const
+        {
+            std::stringstream ss;
+            if (durations.empty())
+                return "{\"count\":0}";
+            std::vector<double> sorted(durations);
+            std::sort(sorted.begin(), sorted.end());
+            const auto mean = std::accumulate(sorted.cbegin(), sorted.cend(), 0.0) / sorted.size();
+            ss << "{\"count\":" << sorted.size() << ",\"min\":" << sorted.front() << ",\"mean\":" << mean << ",\"p50\":" << sorted[sorted.size() / 2] << ",\"p99\":" << sorted[sorted.size() * 99 / 100] << ",\"max\":" << sorted.back() << '}';
+            return ss.str();
+        }
+
+        std::vector<double> durations; // the collected durations, in microseconds..
+    };
+
+#ifdef LATENCY_HISTOGRAMS
+    std::string to_json(const ratio::executor::latency_histogram &hist)
+    {
+        std::stringstream ss;
+        ss << "{\"count\":" << hist.get_count() << ",\"min\":" << hist.get_min() << ",\"mean\":" << hist.get_mean() << ",\"p50\":" << hist.get_percentile(0.5) << ",\"p99\":" << hist.get_percentile(0.99) << ",\"max\":" << hist.get_max() << '}';
+        return ss.str();
+    }
+#endif
+
+    /**
+     * @brief Solves the problem `rounds` times from the root level, with the execution paused, so that the adaptations stored so far are propagated again at each round without being changed.
+     */
+    samples resolve(ratio::executor::executor &exec, const size_t &rounds)
+    {
+        samples smpls;
+        for (size_t i = 0; i < rounds; ++i)
+        {
+            const auto start = bench_clock::now();
+            exec.adapt(std::string());
+            exec.tick();
+            smpls.add(bench_clock::now() - start);
+        }
+        return smpls;
+    }
+
+    /**
+     * @brief Assumes and retracts the execution variable `rounds` times, without solving, so that the bounds of the same active adaptations are propagated at each round.
+     *
+     * The solver first goes back below the decision level at which the execution variable has been assumed, the adaptations activated by the lower levels being the ones which are propagated. Nothing is measured if the execution variable holds at root level.
+     */
+    samples assume_xi(ratio::executor::executor &exec, const size_t &rounds)
+    {
+        samples smpls;
+        auto &sat = exec.get_solver().get_sat_core();
+        const auto &xi = exec.get_xi();
+        while (!sat.root_level() && sat.value(xi) != utils::Undefined)
+            sat.pop();
+        if (sat.value(xi) != utils::Undefined)
+            return smpls;
+        for (size_t i = 0; i < rounds; ++i)
+        {
+            const auto start = bench_clock::now();
+            const auto consistent = sat.assume(xi);
+            sat.pop();
+            smpls.add(bench_clock::now() - start);
+            if (!consistent) // the active bounds are inconsistent: the same conflict would be found at each round..
+                break;
+        }
+        return smpls;
+    }
+
+    /**
+     * @brief A listener which delays the start of one every `delay_every` starting atoms.
+     */
+    class bench_listener : public ratio::executor::executor_listener
+    {
+    public:
+        bench_listener(ratio::executor::executor &e, const size_t &delay_every) : executor_listener(e), delay_every(delay_every) {}
+
+        size_t get_delays() const { return delays; }
+        const std::vector<std::unordered_set<ratio::atom *>> &get_started() const { return started; }
+
+    private:
+        void tick(const utils::rational &) override {}
+
+        void starting(const std::unordered_set<ratio::atom *> &atms) override
+        {
+            if (!delay_every)
+                return;
+            std::unordered_map<const ratio::atom *, utils::rational> dont_start;
+            for (const auto &atm : atms)
+                if (++starting_atms % delay_every == 0)
+                    dont_start.emplace(atm, utils::rational::ONE);
+            if (!dont_start.empty())
+            {
+                delays += dont_start.size();
+                exec.dont_start_yet(dont_start);
+            }
+        }
+
+        void start(const std::unordered_set<ratio::atom *> &atms) override
+        {
+            if (started.size() < 1000) // we keep some started atoms for the serialization benchmark..
+                started.push_back(atms);
+        }
+
+    private:
+        const size_t delay_every;
+        size_t starting_atms = 0, delays = 0;
+        std::vector<std::unordered_set<ratio::atom *>> started;
+    };
+
+    /**
+     * @brief Returns the throughput, in megabytes per second, of serializing the given sets of atoms through the `serialize` function.
+     */
+    template <typename F>
+    double serialization_throughput(const std::vector<std::unordered_set<ratio::atom *>> &atms, F serialize)
+    {
+        size_t bytes = 0;
+        const auto start = bench_clock::now();
+        for (size_t i = 0; i < 100; ++i)
+            for (const auto &c_atms : atms)
+                bytes += serialize(c_atms);
+        const auto elapsed = std::chrono::duration<double>(bench_clock::now() - start).count();
+        return elapsed > 0 ? bytes / elapsed / 1e6 : 0;
+    }
+
+    /**
+     * @brief Generates a synthetic problem with `n_timelines` state variables and `n_atoms` impulse, interval and state variable atoms.
+     */
+    std::string generate_problem(const size_t &n_timelines, const size_t &n_atoms)
+    {
+        std::stringstream ss;
+        ss << "predicate Pulse() : Impulse {}\n";
+        ss << "predicate Task() : Interval { duration >= 1.0; }\n";
+        ss << "class Timeline : StateVariable { predicate Busy() { duration >= 1.0; } }\n";
+        for (size_t i = 0; i < n_timelines; ++i)
+            ss << "Timeline tl" << i << " = new Timeline();\n";
+        for (size_t i = 0; i < n_atoms; ++i)
+            switch (i % 3)
+            {
+            case 0:
+                ss << "fact p" << i << " = new Pulse(at:" << 1 + i / 3 << ".0);\n";
+                break;
+            case 1:
+                ss << "fact t" << i << " = new Task(start:" << 1 + i / 3 << ".0, duration:2.0);\n";
+                break;
+            case 2:
+            { // the busy atoms of the same timeline do not overlap..
+                const auto b = i / 3;
+                ss << "goal b" << i << " = new tl" << b % n_timelines << ".Busy(start:" << 1 + 3 * (b / n_timelines) << ".0, duration:2.0);\n";
+                break;
+            }
+            }
+        return ss.str();
+    }
+
+    long peak_rss_kb()
+    {
+#ifdef _WIN32
+        return -1;
+#else
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024; // bytes on macOS..
+#else
+        return usage.ru_maxrss;
+#endif
+#endif
+    }
+} // namespace
+
+/**
+ * @brief Measures the executor on a synthetic problem, printing the results as a JSON object on the standard output.
+ *
+ * Usage: plexa_bench [timelines] [atoms] [delay_every] [max_ticks] [incremental]
+ *
+ * Running with `incremental` set to 0 rebuilds the timelines from scratch at each solution, so that the cost of maintaining the timelines can be isolated by comparing the two runs.
+ *
+ * Once the execution is over, the timelines are measured by solving the problem again from the root level, first rebuilding them from scratch and then updating them incrementally at each solution. Similarly, the propagation of the adaptations is measured on the fixed set of adaptations done during the execution, by solving the problem again from the root level with the execution paused. Finally, the propagation of the bounds alone is measured by repeatedly assuming and retracting the execution variable over the adaptations active in the last solution, without solving. The time spent within the executor's timelines maintenance and propagation is reported only when built with `LATENCY_HISTOGRAMS`.
+ */
+int main(int argc, char const *argv[])
+{
+    const size_t n_timelines = argc > 1 ? std::stoul(argv[1]) : 10;
+    const size_t n_atoms = argc > 2 ? std::stoul(argv[2]) : 1000;
+    const size_t delay_every = argc > 3 ? std::stoul(argv[3]) : 10;
+    const size_t max_ticks = argc > 4 ? std::stoul(argv[4]) : 10000;
+    const bool incremental = argc > 5 ? std::stoul(argv[5]) != 0 : true;
+
+    ratio::solver slv;
+    ratio::executor::executor exec(slv, "bench");
+    exec.set_incremental(incremental);
+    bench_listener l(exec, delay_every);
+
+    // we read and solve the problem, building the timelines..
+    auto start = bench_clock::now();
+    slv.read(generate_problem(n_timelines, n_atoms));
+    if (!slv.solve())
+    {
+        std::cerr << "the generated problem is unsolvable.." << std::endl;
+        return 1;
+    }
+    const auto solving = bench_clock::now() - start;
+
+    samples tick_smpls, delay_smpls, adapt_smpls, failure_smpls;
+    size_t ticks = 0, failures = 0;
+    try
+    {
+        exec.start_execution();
+        while (exec.get_state() != ratio::executor::Finished && ticks < max_ticks)
+        {
+            const auto delays = l.get_delays();
+            start = bench_clock::now();
+            exec.tick();
+            (l.get_delays() > delays ? delay_smpls : tick_smpls).add(bench_clock::now() - start);
+            ++ticks;
+
+            if (ticks % 100 == 0)
+            { // we re-solve the problem from the root level, propagating the bounds of all the adaptations done so far..
+                start = bench_clock::now();
+                exec.adapt(std::string());
+                exec.tick();
+                adapt_smpls.add(bench_clock::now() - start);
+                ++ticks;
+            }
+
+            if (ticks % 250 == 0 && !exec.get_executing_atoms().empty())
+            { // we make an executing atom fail..
+                ++failures;
+                start = bench_clock::now();
+                exec.failure({*exec.get_executing_atoms().cbegin()});
+                failure_smpls.add(bench_clock::now() - start);
+            }
+        }
+    }
+    catch (const ratio::executor::execution_exception &)
+    { // the last failure could not be recovered..
+    }
+
+    // we measure the timelines maintenance and the propagation of the adaptations done so far..
+    samples build_smpls, update_smpls, propagation_smpls, assume_xi_smpls;
+    std::string build_ns = "null", update_ns = "null", propagate_ns = "null", assume_xi_ns = "null";
+    try
+    {
+        exec.pause_execution();
+
+        exec.set_incremental(false);
+#ifdef LATENCY_HISTOGRAMS
+        exec.reset_latencies();
+#endif
+        build_smpls = resolve(exec, 20);
+#ifdef LATENCY_HISTOGRAMS
+        build_ns = to_json(exec.get_latencies(ratio::executor::TimelinesPhase));
+#endif
+
+        exec.set_incremental(true);
+#ifdef LATENCY_HISTOGRAMS
+        exec.reset_latencies();
+#endif
+        update_smpls = resolve(exec, 20);
+#ifdef LATENCY_HISTOGRAMS
+        update_ns = to_json(exec.get_latencies(ratio::executor::TimelinesPhase));
+#endif
+
+        exec.set_incremental(incremental);
+#ifdef LATENCY_HISTOGRAMS
+        exec.reset_latencies();
+#endif
+        propagation_smpls = resolve(exec, 20);
+#ifdef LATENCY_HISTOGRAMS
+        propagate_ns = to_json(exec.get_latencies(ratio::executor::PropagatePhase));
+#endif
+
+#ifdef LATENCY_HISTOGRAMS
+        exec.reset_latencies();
+#endif
+        assume_xi_smpls = assume_xi(exec, 1000);
+#ifdef LATENCY_HISTOGRAMS
+        assume_xi_ns = to_json(exec.get_latencies(ratio::executor::PropagatePhase));
+#endif
+    }
+    catch (const ratio::executor::execution_exception &)
+    { // the problem has become unsolvable..
+    }
+
+    // we compare the serialization of the messages through the JSON trees and through the streaming writer..
+    const auto tree_mbps = serialization_throughput(l.get_started(), [&exec](const std::unordered_set<ratio::atom *> &atms)
+                                                    { return ratio::executor::start_message(exec, atms).dump().size(); });
+    ratio::executor::message_writer writer;
+    const auto writer_mbps = serialization_throughput(l.get_started(), [&exec, &writer](const std::unordered_set<ratio::atom *> &atms)
+                                                      { return writer.start(exec, atms).size(); });
+    ratio::executor::binary_writer bin_writer;
+    const auto binary_mbps = serialization_throughput(l.get_started(), [&exec, &bin_writer](const std::unordered_set<ratio::atom *> &atms)
+                                                      { return bin_writer.start(exec, atms).size(); });
+    size_t json_bytes = 0, binary_bytes = 0;
+    for (const auto &atms : l.get_started())
+    {
+        json_bytes += writer.start(exec, atms).size();
+        binary_bytes += bin_writer.start(exec, atms).size();
+    }
+
+    std::cout << "{\"timelines\":" << n_timelines << ",\"atoms\":" << n_atoms << ",\"incremental\":" << (incremental ? "true" : "false") << ",\"ticks\":" << ticks << ",\"delays\":" << l.get_delays() << ",\"failures\":" << failures << ",\"solving_ms\":" << std::chrono::duration<double, std::milli>(solving).count() << ",\"tick_us\":" << tick_smpls.to_json() << ",\"delay_tick_us\":" << delay_smpls.to_json() << ",\"adapt_us\":" << adapt_smpls.to_json() << ",\"failure_us\":" << failure_smpls.to_json() << ",\"build_timelines_us\":" << build_smpls.to_json() << ",\"build_timelines_ns\":" << build_ns << ",\"update_timelines_us\":" << update_smpls.to_json() << ",\"update_timelines_ns\":" << update_ns << ",\"propagation_us\":" << propagation_smpls.to_json() << ",\"propagate_ns\":" << propagate_ns << ",\"assume_xi_us\":" << assume_xi_smpls.to_json() << ",\"assume_xi_ns\":" << assume_xi_ns << ",\"json_tree_mbps\":" << tree_mbps << ",\"json_writer_mbps\":" << writer_mbps << ",\"binary_writer_mbps\":" << binary_mbps << ",\"json_bytes\":" << json_bytes << ",\"binary_bytes\":" << binary_bytes << ",\"peak_rss_kb\":" << peak_rss_kb() << '}' << std::endl;
+    return 0;
+}
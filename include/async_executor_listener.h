@@ -0,0 +1,93 @@
+#pragma once
+
+#include "executor_listener.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace ratio::executor
+{
+  /**
+   * @brief An executor listener which receives the `executor_state_changed`, `tick`, `start` and `end` notifications on its own thread.
+   *
+   * The notifications are pushed into a bounded ring buffer and consumed by a dedicated thread, so that slow listeners do not stall the execution of the plan. The executing thread blocks only when the ring buffer is full. The `starting` and `ending` notifications, which allow delaying the atoms, are still delivered synchronously.
+   *
+   * The listener thread is not started by the constructor, since it would call the asynchronous callbacks of a partially constructed listener: derived classes should call `start` at the end of their constructor, and `stop` in their destructor, so that no notification is delivered to a partially constructed, or destroyed, listener. The notifications received before `start` are kept in the ring buffer. Without `MULTIPLE_EXECUTORS`, the asynchronous callbacks should not call the executor.
+   */
+  class async_executor_listener : public executor_listener
+  {
+    struct notification
+    {
+      enum kind
+      {
+        StateChanged,
+        Tick,
+        Start,
+        End
+      };
+
+      kind type = Tick;
+      executor_state state = executor_state::Reasoning;
+      utils::rational time;
+      std::unordered_set<ratio::atom *> atoms;
+    };
+
+  public:
+    /**
+     * @brief Construct a new asynchronous executor listener object.
+     *
+     * @param e the executor to listen to.
+     * @param capacity the maximum number of pending notifications.
+     */
+    PLEXA_EXPORT async_executor_listener(executor &e, const size_t &capacity = 1024);
+    PLEXA_EXPORT virtual ~async_executor_listener();
+
+    /**
+     * @brief Starts the listener thread, delivering the pending notifications. Does nothing if the listener thread is already running.
+     */
+    PLEXA_EXPORT void start();
+
+    /**
+     * @brief Delivers the pending notifications and stops the listener thread.
+     */
+    PLEXA_EXPORT void stop();
+
+  private:
+    void executor_state_changed(executor_state state) override final;
+    void tick(const utils::rational &time) override final;
+    void start(const std::unordered_set<ratio::atom *> &atoms) override final;
+    void end(const std::unordered_set<ratio::atom *> &atoms) override final;
+
+    void push(notification &&n);
+    void dispatch();
+
+    /**
+     * @brief Notifies the listener, on the listener thread, that the state of the executor has changed.
+     */
+    virtual void async_executor_state_changed([[maybe_unused]] executor_state state) {}
+    /**
+     * @brief Notifies the listener, on the listener thread, the passing of time.
+     */
+    virtual void async_tick([[maybe_unused]] const utils::rational &time) {}
+    /**
+     * @brief Notifies the listener, on the listener thread, that some atoms have started.
+     *
+     * @param atoms the set of atoms which have started.
+     */
+    virtual void async_start(const std::unordered_set<ratio::atom *> &) {}
+    /**
+     * @brief Notifies the listener, on the listener thread, that some atoms have ended.
+     *
+     * @param atoms the set of atoms which have ended.
+     */
+    virtual void async_end(const std::unordered_set<ratio::atom *> &) {}
+
+  private:
+    std::vector<notification> buffer; // the ring buffer of the pending notifications..
+    size_t head = 0, size = 0;        // the position of the oldest pending notification and the number of pending notifications..
+    bool stopping = false;
+    std::mutex mtx;
+    std::condition_variable not_empty, not_full;
+    std::thread th;
+  };
+} // namespace ratio::executor
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "executor.h"
+#include <cstdint>
+
+namespace ratio::executor
+{
+  /**
+   * @brief The compact binary encoding of the execution events.
+   *
+   * Each message starts with a fixed 8 bytes header: a magic byte, the format version, the message type, a reserved byte and the payload length as a 32 bits little-endian unsigned integer. The payload contains the solver id as a varint followed by, depending on the message type, the executor state as a single byte, the time as a zigzag varint numerator and a positive varint denominator, or the number of atoms followed by their ids, sorted and delta encoded as varints.
+   */
+  namespace wire
+  {
+    constexpr uint8_t magic = 0xEE;
+    constexpr uint8_t version = 1;
+    constexpr size_t header_size = 8;
+
+    enum message_type : uint8_t
+    {
+      StateChanged = 1,
+      Tick,
+      Starting,
+      Start,
+      Ending,
+      End
+    };
+
+    /**
+     * @brief A decoded execution event.
+     */
+    struct event
+    {
+      message_type type = Tick;
+      uintptr_t solver_id = 0;
+      executor_state state = executor_state::Reasoning; // for the state change messages..
+      int64_t num = 0, den = 1;                         // the time, for the tick messages..
+      std::vector<uintptr_t> atoms;                     // the atom ids, for the starting, start, ending and end messages..
+    };
+
+    /**
+     * @brief Decodes the message at the beginning of the given bytes.
+     *
+     * @param data the bytes to decode.
+     * @param size the number of available bytes.
+     * @param evt the decoded event.
+     * @return size_t the number of consumed bytes, or 0 if the bytes do not contain a whole message yet.
+     * @throws std::invalid_argument if the bytes do not contain a valid message.
+     */
+    PLEXA_EXPORT size_t decode(const uint8_t *data, const size_t &size, event &evt);
+  } // namespace wire
+
+  /**
+   * @brief A writer which encodes the executor messages into a reusable buffer, according to the compact binary encoding.
+   */
+  class binary_writer final
+  {
+  public:
+    /**
+     * @brief Gets the encoded message.
+     *
+     * @return const std::vector<uint8_t>& the encoded message, valid until the next write.
+     */
+    const std::vector<uint8_t> &data() const { return buffer; }
+
+    PLEXA_EXPORT const std::vector<uint8_t> &executor_state_changed(const executor &exec);
+    PLEXA_EXPORT const std::vector<uint8_t> &tick(const executor &exec, const utils::rational &time);
+    PLEXA_EXPORT const std::vector<uint8_t> &starting(const executor &exec, const std::unordered_set<ratio::atom *> &atoms);
+    PLEXA_EXPORT const std::vector<uint8_t> &start(const executor &exec, const std::unordered_set<ratio::atom *> &atoms);
+    PLEXA_EXPORT const std::vector<uint8_t> &ending(const executor &exec, const std::unordered_set<ratio::atom *> &atoms);
+    PLEXA_EXPORT const std::vector<uint8_t> &end(const executor &exec, const std::unordered_set<ratio::atom *> &atoms);
+
+  private:
+    void begin(const wire::message_type &type, const executor &exec);
+    void write_atoms(const std::unordered_set<ratio::atom *> &atoms);
+    void write_varint(uint64_t val);
+    void finish();
+
+  private:
+    std::vector<uint8_t> buffer;  // the reusable buffer, cleared but never shrunk..
+    std::vector<uintptr_t> ids; // the reusable buffer for sorting the atom ids..
+  };
+} // namespace ratio::executor
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+
+namespace ratio::executor
+{
+  /**
+   * @brief A vector whose elements are stored in fixed-size chunks, shared among the copies of the vector until modified.
+   *
+   * Copying the vector copies only the pointers to its chunks, while modifying an element through the non-const accessors copies its chunk, if shared with some other copy. Hence, copying a large vector and then modifying a few of its elements costs in the order of the number of chunks, rather than of the elements. Reading the elements through the const accessors never copies their chunks. The copies can be handed over to other threads, as long as each copy is used by a single thread at a time.
+   *
+   * @tparam T the type of the elements.
+   * @tparam ChunkSize the number of elements of each chunk.
+   */
+  template <typename T, size_t ChunkSize = 64>
+  class cow_vector final
+  {
+    using chunk = std::vector<T>;
+
+  public:
+    class const_iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const T *;
+      using reference = const T &;
+
+      const_iterator(const cow_vector &v, const size_t &pos) : v(&v), pos(pos) {}
+
+      reference operator*() const { return (*v)[pos]; }
+      pointer operator->() const { return &(*v)[pos]; }
+      const_iterator &operator++()
+      {
+        ++pos;
+        return *this;
+      }
+      const_iterator operator++(int)
+      {
+        auto tmp = *this;
+        ++pos;
+        return tmp;
+      }
+      bool operator==(const const_iterator &other) const { return pos == other.pos; }
+      bool operator!=(const const_iterator &other) const { return pos != other.pos; }
+
+    private:
+      const cow_vector *v;
+      size_t pos;
+    };
+
+    size_t size() const noexcept { return n; }
+    bool empty() const noexcept { return !n; }
+
+    const T &operator[](const size_t &pos) const { return (*chunks[pos / ChunkSize])[pos % ChunkSize]; }
+    /**
+     * @brief Gets the element at the given position for modifying it, copying its chunk if shared.
+     */
+    T &operator[](const size_t &pos) { return own(pos / ChunkSize)[pos % ChunkSize]; }
+    const T &back() const { return (*this)[n - 1]; }
+
+    const_iterator begin() const { return const_iterator(*this, 0); }
+    const_iterator end() const { return const_iterator(*this, n); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+      if (n % ChunkSize == 0)
+      { // the last chunk is full..
+        chunks.push_back(std::make_shared<chunk>());
+        chunks.back()->reserve(ChunkSize);
+      }
+      auto &val = own(chunks.size() - 1).emplace_back(std::forward<Args>(args)...);
+      ++n;
+      return val;
+    }
+    void push_back(const T &val) { emplace_back(val); }
+    void pop_back()
+    {
+      assert(n);
+      if (--n % ChunkSize == 0)
+        chunks.pop_back();
+      else
+        own(chunks.size() - 1).pop_back();
+    }
+    void resize(const size_t &c_n, const T &val = T())
+    {
+      while (n > c_n)
+        pop_back();
+      while (n < c_n)
+        emplace_back(val);
+    }
+    void clear() noexcept
+    {
+      chunks.clear();
+      n = 0;
+    }
+
+  private:
+    chunk &own(const size_t &c)
+    {
+      if (chunks[c].use_count() > 1)
+      { // the chunk is shared with some other copy: we copy it before modifying it..
+        auto c_chunk = std::make_shared<chunk>();
+        c_chunk->reserve(ChunkSize);
+        c_chunk->assign(chunks[c]->cbegin(), chunks[c]->cend());
+        chunks[c] = std::move(c_chunk);
+      }
+      return *chunks[c];
+    }
+
+  private:
+    std::vector<std::shared_ptr<chunk>> chunks; // the chunks, all full but the last one..
+    size_t n = 0;                                // the number of elements..
+  };
+
+  /**
+   * @brief A sequence whose elements are stored in variable-size chunks, shared among the copies of the sequence until modified, allowing the insertion and the removal of elements at any position.
+   *
+   * As in `cow_vector`, copying the sequence copies only the pointers to its chunks, and modifying an element, as well as inserting or removing it, copies only its chunk, if shared with some other copy. The positions are meant for sorted sequences, which are searched through `lower_bound`, and are invalidated by any insertion or removal.
+   *
+   * @tparam T the type of the elements.
+   * @tparam ChunkSize the number of elements of the chunks created by appending, the chunks growing beyond twice this size being split.
+   */
+  template <typename T, size_t ChunkSize = 64>
+  class cow_sequence final
+  {
+    using chunk = std::vector<T>;
+
+  public:
+    struct position
+    {
+      size_t chunk, offset;
+
+      bool operator==(const position &other) const { return chunk == other.chunk && offset == other.offset; }
+      bool operator!=(const position &other) const { return !(*this == other); }
+    };
+
+    class const_iterator
+    {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const T *;
+      using reference = const T &;
+
+      const_iterator(const cow_sequence &s, const position &pos) : s(&s), pos(pos) {}
+
+      reference operator*() const { return s->get(pos); }
+      pointer operator->() const { return &s->get(pos); }
+      const_iterator &operator++()
+      {
+        if (++pos.offset == s->chunks[pos.chunk]->size())
+          pos = {pos.chunk + 1, 0};
+        return *this;
+      }
+      const_iterator operator++(int)
+      {
+        auto tmp = *this;
+        ++*this;
+        return tmp;
+      }
+      bool operator==(const const_iterator &other) const { return pos == other.pos; }
+      bool operator!=(const const_iterator &other) const { return pos != other.pos; }
+
+    private:
+      const cow_sequence *s;
+      position pos;
+    };
+
+    size_t size() const noexcept { return n; }
+    bool empty() const noexcept { return !n; }
+
+    const_iterator begin() const { return const_iterator(*this, {0, 0}); }
+    const_iterator end() const { return const_iterator(*this, end_position()); }
+
+    /**
+     * @brief Gets the position past the last element.
+     */
+    position end_position() const noexcept { return {chunks.size(), 0}; }
+    /**
+     * @brief Gets the position of the first element which does not precede `key`, according to `comp`, as in `std::lower_bound`.
+     */
+    template <typename K, typename Compare>
+    position lower_bound(const K &key, Compare comp) const
+    {
+      // the chunks are empty only if the sequence is empty, hence the last element of each chunk tells whether the chunk precedes the key..
+      const auto c = std::partition_point(chunks.cbegin(), chunks.cend(), [&key, &comp](const std::shared_ptr<chunk> &ch)
+                                          { return comp(ch->back(), key); });
+      if (c == chunks.cend())
+        return end_position();
+      return {static_cast<size_t>(c - chunks.cbegin()), static_cast<size_t>(std::lower_bound((*c)->cbegin(), (*c)->cend(), key, comp) - (*c)->cbegin())};
+    }
+
+    const T &get(const position &pos) const { return (*chunks[pos.chunk])[pos.offset]; }
+    /**
+     * @brief Gets the element at the given position for modifying it, copying its chunk if shared.
+     */
+    T &get(const position &pos) { return own(pos.chunk)[pos.offset]; }
+    const T &back() const { return chunks.back()->back(); }
+
+    template <typename... Args>
+    T &emplace(const position &pos, Args &&...args)
+    {
+      if (pos == end_position())
+        return emplace_back(std::forward<Args>(args)...);
+      auto &c = own(pos.chunk);
+      c.emplace(c.begin() + pos.offset, std::forward<Args>(args)...);
+      ++n;
+      if (c.size() <= 2 * ChunkSize)
+        return c[pos.offset];
+      // the chunk has grown too much: we split it in two halves..
+      auto c_chunk = std::make_shared<chunk>(std::make_move_iterator(c.begin() + c.size() / 2), std::make_move_iterator(c.end()));
+      c.erase(c.begin() + c.size() / 2, c.end());
+      chunks.insert(chunks.begin() + pos.chunk + 1, c_chunk);
+      return pos.offset < c.size() ? c[pos.offset] : (*c_chunk)[pos.offset - c.size()];
+    }
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+      if (chunks.empty() || chunks.back()->size() >= ChunkSize)
+      { // the last chunk is full..
+        chunks.push_back(std::make_shared<chunk>());
+        chunks.back()->reserve(ChunkSize);
+      }
+      auto &val = own(chunks.size() - 1).emplace_back(std::forward<Args>(args)...);
+      ++n;
+      return val;
+    }
+
+    void erase(const position &pos)
+    {
+      auto &c = own(pos.chunk);
+      c.erase(c.begin() + pos.offset);
+      --n;
+      if (c.empty())
+        chunks.erase(chunks.begin() + pos.chunk);
+    }
+    /**
+     * @brief Removes the last element, returning it. The element is moved out of its chunk, unless the chunk is shared.
+     */
+    T take_back()
+    {
+      assert(n);
+      auto val = chunks.back().use_count() > 1 ? T(chunks.back()->back()) : std::move(chunks.back()->back());
+      pop_back();
+      return val;
+    }
+    void pop_back()
+    {
+      assert(n);
+      --n;
+      if (chunks.back()->size() == 1)
+        chunks.pop_back();
+      else
+        own(chunks.size() - 1).pop_back();
+    }
+    void clear() noexcept
+    {
+      chunks.clear();
+      n = 0;
+    }
+
+  private:
+    chunk &own(const size_t &c)
+    {
+      if (chunks[c].use_count() > 1) // the chunk is shared with some other copy: we copy it before modifying it..
+        chunks[c] = std::make_shared<chunk>(*chunks[c]);
+      return *chunks[c];
+    }
+
+  private:
+    std::vector<std::shared_ptr<chunk>> chunks; // the non-empty chunks..
+    size_t n = 0;                                // the number of elements..
+  };
+} // namespace ratio::executor
@@ -4,11 +4,36 @@
 #include "core_listener.h"
 #include "solver_listener.h"
 #include "solver.h"
+#include "lra_value_listener.h"
+#include "memory_arena.h"
+#include "cow_vector.h"
+#include <optional>
+#include <memory>
+#include <iosfwd>
+#include <cstdio>
+#include <limits>
+#include <deque>
+#include <unordered_set>
+#ifdef LATENCY_HISTOGRAMS
+#include "latency_histogram.h"
+#include <array>
+#endif
 #ifdef MULTIPLE_EXECUTORS
+#include "mpsc_queue.h"
+#include <functional>
 #include <mutex>
 #include <atomic>
+#include <thread>
+#include <exception>
 #endif
 
+namespace ratio
+{
+  class bool_item;
+  class arith_item;
+  class enum_item;
+} // namespace ratio
+
 namespace ratio::executor
 {
   class executor_listener;
@@ -23,41 +48,95 @@ namespace ratio::executor
     Failed
   };
 
-  struct atom_adaptation
+#ifdef LATENCY_HISTOGRAMS
+  enum latency_phase
   {
-    struct item_bounds
-    {
-      virtual ~item_bounds() = default;
-    };
-    using bounds_ptr = utils::u_ptr<item_bounds>;
+    TickPhase,      // a whole tick..
+    SolvePhase,     // the solving of the pending requirements and of the delayed plan, within a tick..
+    NotifyPhase,    // the `starting` and `ending` notifications, within a tick..
+    DelayPhase,     // the collection and the enforcement of the requested delays, within a tick..
+    FreezePhase,    // the freezing of the starting and of the ending atoms, within a tick..
+    DispatchPhase,  // the `start`, `end`, `tick` and state notifications, within a tick..
+    AdaptPhase,     // the reading of the requirements of an adaptation..
+    FailurePhase,   // the handling of a failure, including the search for a new solution..
+    TimelinesPhase, // the building or the updating of the timelines..
+    PropagatePhase, // the propagation of the adaptations..
+    PhaseCount
+  };
+#endif
 
-    struct bool_bounds : public item_bounds
+  struct atom_adaptation
+  {
+    struct bool_bounds
     {
-      bool_bounds(const utils::lbool &val) : val(val) {}
-      const utils::lbool val;
+      bool_bounds(const ratio::bool_item &itm, const utils::lbool &val) : itm(&itm), val(val) {}
+      const ratio::bool_item *itm;
+      utils::lbool val;
     };
-    struct arith_bounds : public item_bounds
+    struct arith_bounds
     {
-      arith_bounds(const utils::inf_rational &lb, const utils::inf_rational &ub) : lb(lb), ub(ub) {}
+      arith_bounds(const ratio::arith_item &itm, const utils::inf_rational &lb, const utils::inf_rational &ub) : itm(&itm), lb(lb), ub(ub) {}
+      const ratio::arith_item *itm;
       utils::inf_rational lb, ub;
     };
-    struct var_bounds : public item_bounds
+    struct var_bounds
     {
-      var_bounds(utils::enum_val &val) : val(val) {}
-      utils::enum_val &val;
+      var_bounds(const ratio::enum_item &itm, utils::enum_val &val) : itm(&itm), val(&val) {}
+      const ratio::enum_item *itm;
+      utils::enum_val *val;
     };
 
-    atom_adaptation(const semitone::lit &sigma_xi) : sigma_xi(sigma_xi) {}
+    atom_adaptation(const semitone::lit &sigma_xi, memory_arena &arena) : sigma_xi(sigma_xi), bool_bnds(arena_allocator<bool_bounds>(arena)), arith_bnds(arena_allocator<arith_bounds>(arena)), var_bnds(arena_allocator<var_bounds>(arena)) {}
+
+    /**
+     * @brief Checks whether this adaptation has no bounds.
+     *
+     * @return true if this adaptation has no bounds.
+     * @return false if this adaptation has some bounds.
+     */
+    bool empty() const noexcept { return bool_bnds.empty() && arith_bnds.empty() && var_bnds.empty(); }
+
+    /**
+     * @brief Gets the bounds of the given item, if any.
+     *
+     * @param itm the item whose bounds are requested.
+     * @return the bounds of the item, or `nullptr` if the item has no bounds.
+     */
+    bool_bounds *get_bounds(const ratio::bool_item &itm) noexcept
+    {
+      for (auto &bnds : bool_bnds)
+        if (bnds.itm == &itm)
+          return &bnds;
+      return nullptr;
+    }
+    arith_bounds *get_bounds(const ratio::arith_item &itm) noexcept
+    {
+      for (auto &bnds : arith_bnds)
+        if (bnds.itm == &itm)
+          return &bnds;
+      return nullptr;
+    }
+    var_bounds *get_bounds(const ratio::enum_item &itm) noexcept
+    {
+      for (auto &bnds : var_bnds)
+        if (bnds.itm == &itm)
+          return &bnds;
+      return nullptr;
+    }
 
     semitone::lit sigma_xi;
-    std::unordered_map<riddle::item *, bounds_ptr> bounds;
+    std::vector<bool_bounds, arena_allocator<bool_bounds>> bool_bnds;    // the propositional bounds..
+    std::vector<arith_bounds, arena_allocator<arith_bounds>> arith_bnds; // the arithmetic bounds..
+    std::vector<var_bounds, arena_allocator<var_bounds>> var_bnds;       // the enumerative bounds..
   };
 
-  class executor final : public riddle::core_listener, public ratio::solver_listener, public semitone::theory
+  class executor final : public riddle::core_listener, public ratio::solver_listener, public semitone::theory, public semitone::lra_value_listener
   {
     friend class executor_listener;
 
   public:
+    class snapshot;
+
     /**
      * @brief Construct a new executor object.
      *
@@ -66,11 +145,18 @@ namespace ratio::executor
      */
     PLEXA_EXPORT executor(ratio::solver &slv, const std::string &name = "default", const utils::rational &units_per_tick = utils::rational::ONE);
     executor(const executor &orig) = delete;
+    PLEXA_EXPORT ~executor();
 
     ratio::solver &get_solver() { return slv; }
     const ratio::solver &get_solver() const { return slv; }
     const std::string &get_name() const { return name; }
     executor_state get_state() const { return state; }
+    /**
+     * @brief Gets the execution variable, whose assumption enforces the bounds of the active adaptations.
+     *
+     * @return const semitone::lit& the execution variable.
+     */
+    const semitone::lit &get_xi() const { return xi; }
 
     /**
      * @brief Gets the current time.
@@ -93,12 +179,82 @@ namespace ratio::executor
      */
     bool is_running() const { return running; }
 
+    /**
+     * @brief Checks whether the timelines are incrementally updated when a new solution is found.
+     *
+     * @return true if only the atoms whose pulses have changed are updated.
+     * @return false if the timelines are rebuilt from scratch at each solution.
+     */
+    bool is_incremental() const { return incremental; }
+    /**
+     * @brief Sets whether the timelines are incrementally updated when a new solution is found.
+     *
+     * When incremental, the executor listens to the (de)activation of the tracked atoms and to the changes of their times, so that only the atoms notified since the last solution are visited.
+     *
+     * @param inc true for updating only the atoms whose pulses have changed, false for rebuilding the timelines from scratch at each solution.
+     */
+    void set_incremental(bool inc) { incremental = inc; }
+
+    /**
+     * @brief Checks whether the solutions following an adaptation are warm-started from the current solution.
+     *
+     * @return true if the decisions of the current solution are replayed before solving the pending requirements.
+     * @return false if the pending requirements are solved from scratch.
+     */
+    bool is_warm_start() const { return warm_start; }
+    /**
+     * @brief Sets whether the solutions following an adaptation are warm-started from the current solution.
+     *
+     * Adding new requirements brings the solver back to the root level. When warm-starting, the resolvers chosen for the current solution are taken again, as long as they are still consistent, before solving the pending requirements, so that the search only resolves the flaws introduced by the new requirements and finds a solution close to the current one. If replaying the decisions fails, the pending requirements are solved from scratch.
+     *
+     * @param ws true for replaying the decisions of the current solution, false for solving the pending requirements from scratch.
+     */
+    void set_warm_start(bool ws) { warm_start = ws; }
+
+#ifdef MULTIPLE_EXECUTORS
+    /**
+     * @brief Checks whether the adaptations requested during the execution are solved in background.
+     *
+     * @return true if the pending requirements are solved by a background thread while the current plan keeps on being executed.
+     * @return false if the pending requirements are solved within the tick.
+     */
+    bool is_background_replanning() const { return background_replanning; }
+    /**
+     * @brief Sets whether the adaptations requested during the execution are solved in background.
+     *
+     * The solver cannot be copied, hence the values of the current plan are captured before the adaptation brings the solver back to the root level, and the solver is handed over to a background thread for solving the pending requirements. In the meanwhile, the ticks keep on dispatching the captured plan, notifying the `starting`, `start`, `ending` and `end` of its atoms, while their freezing is deferred: `get_executing()` is not updated and any request, also when made by the listeners within the notifications, waits for the new plan. The new timelines are swapped in at the first tick following the new solution, once the dispatched atoms have been frozen. If the new solution disagrees with the dispatched values, or starts some atom in the past, the dispatched values are enforced and the problem is solved again within that tick. Adaptations requested while some delays are pending, or while a loaded checkpoint is being restored, are solved within the tick.
+     *
+     * **While replanning, the solver is being modified by the background thread: the listeners must not access it within their notifications** (e.g., reading the values of the notified atoms, serializing them through `to_json`, or building an `executor_state_message`), and can only rely on the identity of the notified atoms. Listeners which read the solver should check `is_replanning()` first. The `Finished` state is notified only once the new plan has been swapped in.
+     *
+     * @param bg true for solving the adaptations in background, false for solving them within the tick.
+     */
+    void set_background_replanning(bool bg) { background_replanning = bg; }
+    /**
+     * @brief Checks whether the background thread is currently solving the pending requirements, hence whether the solver must not be accessed.
+     *
+     * This method is meant to be called by the listeners, within their notifications, on the executing thread.
+     *
+     * @return true if the solver is owned by the background thread.
+     * @return false if the solver can be accessed.
+     */
+    bool is_replanning() const { return replanning; }
+#endif
+
     /**
      * @brief Gets the atoms which are currently executing.
      *
      * @return const std::unordered_set<const ratio::atom *>& the atoms which are currently executing.
      */
-    const std::unordered_set<const ratio::atom *> &get_executing() const { return executing; }
+    const std::unordered_set<const ratio::atom *> &get_executing() const { return executing_set; }
+
+    /**
+     * @brief Gets the atoms which are currently executing, as a dense vector.
+     *
+     * This is cheaper to iterate than `get_executing()`, and contains the same atoms. The vector is shared with the snapshots, hence it is replaced, rather than modified, by the first execution step which starts or ends some atom after a snapshot: the returned reference should not be kept across the execution steps.
+     *
+     * @return const std::vector<const ratio::atom *>& the atoms which are currently executing, in no particular order.
+     */
+    const std::vector<const ratio::atom *> &get_executing_atoms() const { return *executing; }
 
     /**
      * @brief Starts the execution of the current solution.
@@ -117,57 +273,321 @@ namespace ratio::executor
      * Before starting (ending) the execution of a task, the executor notifies the listeners via the `starting` (`ending`) methods. Listeners can here introduce delays through the `dont_start_yet` (`dont_end_yet`) methods.
      */
     PLEXA_EXPORT void tick();
+    /**
+     * @brief Performs `ticks` execution steps at once, jumping over the idle ones.
+     *
+     * The idle steps are skipped without notifying the listeners, while the remaining ones are performed as in `tick()`. This allows drivers which sleep through the idle ticks to catch up with the elapsed time.
+     *
+     * @param ticks the number of execution steps to perform.
+     */
+    PLEXA_EXPORT void tick(const size_t &ticks);
 
+    /**
+     * @brief Gets the time of the next pulse, i.e., the next time at which some atom starts or ends or, if earlier, the horizon.
+     *
+     * @return utils::inf_rational the time of the next pulse, or positive infinity if there are no more pulses.
+     */
+    PLEXA_EXPORT utils::inf_rational get_next_pulse();
+    /**
+     * @brief Gets the number of the following ticks, starting from the current time, in which nothing happens.
+     *
+     * @return size_t the number of idle ticks, or the maximum `size_t` value if nothing will ever happen.
+     */
+    PLEXA_EXPORT size_t get_idle_ticks();
+
+    /**
+     * @brief Adapts the current solution to the requirements of the given script.
+     *
+     * With `MULTIPLE_EXECUTORS`, this request, as well as the `dont_start_yet`, `dont_end_yet` and `failure` ones, never blocks the calling thread: it is enqueued and applied by the executing thread at the beginning of the next tick. The `dont_start_yet` (`dont_end_yet`) requests made by a listener within the `starting` (`ending`) notification are applied right after it, while the requests which might change the timelines (i.e., adaptations, failures, restores and compactions) always wait for the next tick. Any `execution_exception` is hence thrown by `tick()`.
+     *
+     * @param script the script containing the new requirements.
+     */
     PLEXA_EXPORT void adapt(const std::string &script);
     PLEXA_EXPORT void adapt(const std::vector<std::string> &files);
 
-    PLEXA_EXPORT void dont_start_yet(const std::unordered_map<const ratio::atom *, utils::rational> &atoms) { dont_start.insert(atoms.cbegin(), atoms.cend()); }
-    PLEXA_EXPORT void dont_end_yet(const std::unordered_map<const ratio::atom *, utils::rational> &atoms) { dont_end.insert(atoms.cbegin(), atoms.cend()); }
+    PLEXA_EXPORT void dont_start_yet(const std::unordered_map<const ratio::atom *, utils::rational> &atoms);
+    PLEXA_EXPORT void dont_end_yet(const std::unordered_map<const ratio::atom *, utils::rational> &atoms);
     PLEXA_EXPORT void failure(const std::unordered_set<const ratio::atom *> &atoms);
 
+    /**
+     * @brief Takes a snapshot of the execution state, i.e., the current time, the executing atoms, the adaptations, the pending delays and the pulses.
+     *
+     * The snapshot shares the execution state with the executor, copy-on-write: the atoms, the ended atoms, the adaptation records and the pulses are kept in chunks, which are copied only when first modified after the snapshot, and the adaptation records are copied only when changed since the last snapshot. Taking a snapshot hence costs in the order of the number of chunks, rather than of the size of the plan.
+     *
+     * @return snapshot the snapshot of the execution state.
+     */
+    PLEXA_EXPORT snapshot take_snapshot();
+    /**
+     * @brief Rolls the execution state back to the given snapshot, e.g., after an `execution_exception`, so that an alternative adaptation can be tried.
+     *
+     * The solver is brought back to the root level and the restored solution is searched for again at the next tick, without reading the domain again. The atoms created after the snapshot keep their adaptations. The clauses learnt after the snapshot, as well as the bounds enforced at the root level, are not retracted. With `MULTIPLE_EXECUTORS`, the restore is applied at the beginning of the next tick.
+     *
+     * @param snp the snapshot to restore.
+     * @throws std::invalid_argument if the snapshot has been taken before the last compaction. With `MULTIPLE_EXECUTORS`, the exception is thrown by the `tick()` applying the restore, and the execution state is left unchanged.
+     */
+    PLEXA_EXPORT void restore(const snapshot &snp);
+
+    /**
+     * @brief Retires the atoms which have ended before the current tick.
+     *
+     * The retired atoms stay active and their frozen values become permanent root-level facts, so that their bounds are not propagated anymore at each assignment of the execution variable, and their bookkeeping is freed. Since the solver is brought back to the root level, the current solution is searched for again at the next tick: this method is meant to be called sparingly, e.g., every few hundreds of ticks. A compact record of the retired atoms is streamed to an anonymous temporary file, rather than kept in memory, so that the checkpoints can still warm restart the execution. With `MULTIPLE_EXECUTORS`, the compaction is applied at the beginning of the next tick.
+     */
+    PLEXA_EXPORT void compact();
+
+    /**
+     * @brief Periodically writes a checkpoint of the execution state, for warm restarting the execution.
+     *
+     * @param path the path of the checkpoint file, atomically replaced at each checkpoint.
+     * @param every the number of ticks between two checkpoints, or zero for disabling the checkpoints.
+     */
+    PLEXA_EXPORT void set_checkpointing(const std::string &path, const size_t &every);
+    /**
+     * @brief Writes a checkpoint of the execution state, i.e., the current time, the executing atoms, the frozen values and the pending delays.
+     *
+     * Atoms are identified by the variable of their sigma literal and their parameters by name, so that the checkpoint can be loaded by an executor whose solver reads the same problem.
+     *
+     * @param path the path of the checkpoint file, atomically replaced.
+     */
+    PLEXA_EXPORT void save_checkpoint(const std::string &path);
+    /**
+     * @brief Loads a checkpoint for warm restarting the execution.
+     *
+     * This method should be called before the solver reads the problem: the current time is restored immediately, while the frozen values, the executing state and the pending delays of each atom are restored as soon as the atom is created, pruning the search for the first solution.
+     *
+     * @param path the path of the checkpoint file.
+     * @throws std::invalid_argument if the checkpoint file cannot be read or is not a valid checkpoint.
+     */
+    PLEXA_EXPORT void load_checkpoint(const std::string &path);
+
+#ifdef LATENCY_HISTOGRAMS
+    /**
+     * @brief Gets the histogram of the latencies of the given phase.
+     *
+     * The histograms are lock-free, hence they can be queried from any thread while the executor is running.
+     *
+     * @param phase the phase whose latencies are requested.
+     * @return const latency_histogram& the histogram of the latencies of the phase.
+     */
+    const latency_histogram &get_latencies(const latency_phase &phase) const { return latencies[phase]; }
+    /**
+     * @brief Forgets the latencies recorded so far.
+     */
+    PLEXA_EXPORT void reset_latencies() noexcept;
+    /**
+     * @brief Writes the latencies recorded so far.
+     *
+     * For each phase having some latencies, a summary line `# <phase> count=<n> min=<ns> mean=<ns> p50=<ns> p90=<ns> p99=<ns> p99.9=<ns> max=<ns>` is followed by the non-empty buckets of the histogram, one per line, as in `latency_histogram::dump`.
+     *
+     * @param os the stream to write to.
+     */
+    PLEXA_EXPORT void dump_latencies(std::ostream &os) const;
+#endif
+
   private:
     bool propagate(const semitone::lit &p) noexcept override;
     bool check() noexcept override { return true; }
-    void push() noexcept override {}
-    void pop() noexcept override {}
+    void push() noexcept override;
+    void pop() noexcept override;
+
+    void lra_value_change(const semitone::var &x) override;
 
     inline bool is_relevant(const riddle::predicate &pred) const noexcept { return relevant_predicates.count(&pred); }
 
-    void read(const std::string &) override { reset_relevant_predicates(); }
-    void read(const std::vector<std::string> &) override { reset_relevant_predicates(); }
+    void read(const std::string &) override { update_relevant_predicates(); }
+    void read(const std::vector<std::string> &) override { update_relevant_predicates(); }
     void started_solving() override;
     void solution_found() override;
+    void current_resolver(const ratio::resolver &r) override;
     void inconsistent_problem() override;
 
     void flaw_created(const ratio::flaw &f) override;
 
+    struct atom_pulses
+    {
+      std::optional<utils::inf_rational> start, end; // the pulses at which the atom is starting/ending, if any..
+
+      bool operator==(const atom_pulses &other) const { return start == other.start && end == other.end; }
+      bool operator!=(const atom_pulses &other) const { return !(*this == other); }
+    };
+
+    struct pulse
+    {
+      pulse(const utils::inf_rational &time) : time(time) {}
+
+      utils::inf_rational time;                   // the time of the pulse..
+      std::unordered_set<ratio::atom *> starting; // the atoms starting at this pulse..
+      std::unordered_set<ratio::atom *> ending;   // the atoms ending at this pulse..
+    };
+
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    struct indexed_atom
+    {
+      ratio::atom *atm = nullptr;                            // the atom, or `nullptr` if the index is free..
+      std::optional<utils::rational> start_delay, end_delay; // the delays requested for starting (ending) the atom, not applied yet..
+      std::optional<atom_pulses> pulses;                     // the pulses at which the atom is indexed, if the atom is relevant and has not ended yet..
+      size_t executing = npos;                               // the position of the atom within the executing atoms, if executing..
+      bool dirty = false;                                    // whether the adaptation of the atom has changed since the last snapshot..
+      bool moved = false;                                    // whether the sigma or the time values of the atom have changed since the last update of the timelines..
+    };
+
+    struct checkpointed_atom
+    {
+      bool executing = false;                                                              // whether the atom was executing..
+      std::vector<std::pair<std::string, utils::lbool>> bool_bnds;                         // the propositional bounds, by parameter name..
+      std::vector<std::pair<std::string, std::pair<utils::inf_rational, utils::inf_rational>>> arith_bnds; // the arithmetic bounds, by parameter name..
+      std::optional<utils::rational> start_delay, end_delay;                               // the pending delays..
+    };
+
+    struct file_closer
+    {
+      void operator()(std::FILE *f) const { std::fclose(f); }
+    };
+
+    struct atom_delay
+    {
+      const ratio::atom *atm; // the delayed atom..
+      size_t idx;             // the index of the delayed atom..
+      bool starting;          // whether the start or the end of the atom is delayed..
+      utils::rational delay;  // the requested delay..
+    };
+
+    void apply_delays(const std::vector<atom_delay> &delays);
+    void freeze_starting(const std::unordered_set<ratio::atom *> &atms);
+    void freeze_ending(const std::unordered_set<ratio::atom *> &atms);
+
+    size_t index_atom(ratio::atom &atm, const semitone::var &sigma_xi);
+    size_t index_of(const ratio::atom &atm) const noexcept;
+    void set_executing(const size_t &idx);
+    void unset_executing(const size_t &idx);
+    void set_dirty(const size_t &idx);
+    void set_moved(const size_t &idx);
+    std::vector<semitone::var> get_time_vars(const ratio::atom &atm);
+
+    void read_script(const std::string &script);
+    void read_files(const std::vector<std::string> &files);
+    void fail(const std::unordered_set<const ratio::atom *> &atoms);
+    void restore_snapshot(const snapshot &snp);
+    void solve_pending_requirements();
+    void retire_ended_atoms();
+    void write_checkpoint(const std::string &path);
+    checkpointed_atom to_checkpointed(const size_t &idx) const;
+    void write_checkpointed(std::ostream &os, const semitone::var &sigma, const checkpointed_atom &c_atm) const;
+    void restore_checkpointed(const size_t &idx);
+
+    utils::inf_rational next_pulse();
+    size_t idle_ticks();
+
     void build_timelines();
-    bool propagate_bounds(const riddle::item &itm, const atom_adaptation::item_bounds &bounds, const semitone::lit &reason);
+    void update_timelines();
+    atom_pulses compute_pulses(const ratio::atom &atm) const;
+    void add_pulses(ratio::atom &atm, const atom_pulses &pls);
+    void remove_pulses(ratio::atom &atm, const atom_pulses &pls);
+    cow_sequence<pulse>::position find_pulse(const utils::inf_rational &time) const;
+    pulse &get_pulse(const utils::inf_rational &time);
+    bool propagate_bounds(const atom_adaptation &adapt, const semitone::lit &reason);
 
-    void reset_relevant_predicates();
+    void update_relevant_predicates();
+
+#ifdef MULTIPLE_EXECUTORS
+    struct planned_values
+    {
+      std::vector<std::pair<const ratio::bool_item *, utils::lbool>> bools;         // the propositional values..
+      std::vector<std::pair<const ratio::arith_item *, utils::inf_rational>> ariths; // the arithmetic values..
+      std::vector<std::pair<const ratio::enum_item *, utils::enum_val *>> vars;      // the enumerative values..
+    };
+
+    void capture_plan();
+    planned_values get_planned_values(const ratio::atom &atm, const bool &starting) const;
+    bool agrees(const planned_values &vals) const;
+    void enforce(const size_t &idx, const planned_values &vals);
+    void start_replanning();
+    void finish_replanning();
+#endif
 
   private:
     const std::string name;
     executor_state state = executor_state::Reasoning;                  // the current state of the executor..
     std::unordered_set<const riddle::predicate *> relevant_predicates; // impulses and intervals..
+    std::unordered_set<const riddle::type *> classified_types;         // the types and the predicates already classified as relevant or not..
     utils::rational current_time;                                      // the current time in plan units..
     const utils::rational units_per_tick;                              // the number of plan units for each tick..
     semitone::lit xi;                                                  // the execution variable..
     bool pending_requirements = false;                                 // whether there are pending requirements to be solved or not..
+    bool incremental = true;                                           // whether the timelines are incrementally updated or not..
+    bool rebuild = false;                                              // whether the timelines must be rebuilt from scratch at the next solution..
+    bool warm_start = false;                                           // whether the decisions of the current solution are replayed before solving the pending requirements..
+    std::vector<semitone::lit> warm_decisions;                         // the decisions of the current solution, in the order they have been taken..
+    std::vector<semitone::lit> chosen_resolvers;                       // the rho literals of the resolvers chosen since the current solution..
 #ifdef MULTIPLE_EXECUTORS
-    std::mutex mtx;                    // the mutex for the critical sections..
-    std::atomic<bool> running = false; // the running state..
+    std::mutex mtx;                            // the mutex for the critical sections..
+    std::atomic<bool> running = false;         // the running state..
+    mpsc_queue<std::function<void()>> commands;       // the requests coming from other threads, applied by the executing thread at the beginning of the tick..
+    mpsc_queue<std::function<void()>> delay_requests; // the delays requested from any thread, applied also right after the `starting` and `ending` notifications..
+    std::atomic<bool> background_replanning = false;                                             // whether the adaptations are solved in background..
+    bool plan_captured = false;                                                                  // whether the current plan has been captured for being dispatched while replanning..
+    bool replanning = false;                                                                     // whether the background thread owns the solver..
+    bool replanning_failed = false;                                                              // whether the background thread has found the problem inconsistent..
+    std::atomic<bool> replanned = false;                                                         // whether the background thread has finished..
+    std::exception_ptr replanning_exception;                                                     // the exception thrown by the background thread, if any..
+    std::thread replanner;                                                                       // the background thread..
+    utils::rational planned_time;                                                                // the time at which the plan has been captured..
+    utils::inf_rational planned_horizon;                                                         // the horizon of the captured plan..
+    std::unordered_map<const ratio::atom *, planned_values> planned_starts, planned_ends;        // the captured values to be frozen at the start (end) of the atoms..
+    std::vector<std::pair<bool, std::unordered_set<ratio::atom *>>> dispatched;                  // the atoms started (ended) while replanning, whose freezing is deferred..
 #else
     bool running = false; // the execution state..
 #endif
-    std::unordered_set<const ratio::atom *> executing;                               // the atoms currently executing..
-    std::unordered_map<const ratio::atom *, atom_adaptation> adaptations;            // for each atom, the numeric adaptations done during the executions (i.e., freezes and delays)..
-    std::unordered_map<semitone::var, const ratio::atom *> all_atoms;                // all the interesting atoms indexed by their sigma_xi variable..
-    std::unordered_map<const ratio::atom *, utils::rational> dont_start;             // the starting atoms which are not yet ready to start..
-    std::unordered_map<const ratio::atom *, utils::rational> dont_end;               // the ending atoms which are not yet ready to end..
-    std::map<utils::inf_rational, std::unordered_set<ratio::atom *>> s_atms, e_atms; // for each pulse, the atoms starting/ending at that pulse..
-    std::set<utils::inf_rational> pulses;                                            // all the pulses of the plan..
+    std::vector<size_t> var_index;                                                   // for each SAT variable, the index of the atom having it as its sigma or sigma_xi variable, or `npos`..
+    cow_vector<indexed_atom> atoms;                                                  // the interesting atoms, by index..
+    memory_arena arena;                                                              // the arena of the adaptation records, released in bulk with the executor..
+    std::deque<atom_adaptation> adaptations;                                         // for each atom index, the numeric adaptations done during the executions (i.e., freezes and delays), never moved as new atoms are indexed..
+    std::vector<size_t> free_indices;                                                // the indices of the retired atoms, available for reuse..
+    std::shared_ptr<std::vector<const ratio::atom *>> executing = std::make_shared<std::vector<const ratio::atom *>>(); // the atoms currently executing, shared with the snapshots..
+    std::unordered_set<const ratio::atom *> executing_set;                           // the atoms currently executing, for the lookups of the callers..
+    size_t pending_end_delays = 0;                                                   // the number of atoms having an end delay not applied yet..
+    cow_vector<std::shared_ptr<const atom_adaptation>> snapshot_adaptations;         // the adaptation records of the last snapshot, by atom index..
+    std::vector<size_t> dirty_adaptations;                                           // the indices of the atoms whose adaptations have changed since the last snapshot..
+    std::vector<size_t> active_adaptations;                                          // the indices of the adaptations, having some bounds, whose sigma_xi variable is currently true..
+    std::vector<std::pair<size_t, size_t>> layers;                                   // for each decision level, the number of active adaptations and of assigned sigmas..
+    std::vector<size_t> assigned_sigmas;                                             // the indices of the atoms whose sigma variable has been assigned, in assignment order..
+    std::unordered_map<semitone::var, std::vector<size_t>> time_vars;                // for each listened LRA variable, the indices of the tracked atoms whose start, end or at it represents..
+    std::vector<size_t> moved_atoms;                                                 // the indices of the atoms whose sigma or time values have changed since the last update of the timelines..
+    cow_vector<size_t> ended_atoms;                                                  // the indices of the atoms which have ended and have not been retired yet..
+    size_t compactions = 0;                                                          // the number of compactions done so far..
+    cow_sequence<pulse> pulses;                                                      // the pulses of the plan, sorted in decreasing order so that the next pulse is at the back..
+    size_t timelines_changes = 0;                                                    // the number of times the pulses have been rebuilt, updated or replaced, for detecting the changes made by the listeners..
+    std::string checkpoint_path;                                                     // the path of the periodic checkpoints..
+    size_t checkpoint_every = 0, ticks_since_checkpoint = 0;                         // the number of ticks between two periodic checkpoints, and since the last one..
+    std::unordered_map<semitone::var, checkpointed_atom> checkpointed_atoms;         // the loaded atoms, by sigma variable, not created yet..
+    std::unique_ptr<std::FILE, file_closer> retired_atoms;                           // the records of the retired atoms, streamed to an anonymous temporary file for the checkpoints..
+    size_t n_retired_atoms = 0;                                                      // the number of records of the retired atoms..
     std::vector<executor_listener *> listeners;                                      // the executor listeners..
+#ifdef LATENCY_HISTOGRAMS
+    std::array<latency_histogram, PhaseCount> latencies; // the latencies of the phases of the execution..
+#endif
+  };
+
+  class executor::snapshot
+  {
+    friend class executor;
+
+  public:
+    /**
+     * @brief Gets the time at which the snapshot has been taken.
+     *
+     * @return const utils::rational& the time of the snapshot.
+     */
+    const utils::rational &get_time() const { return current_time; }
+
+  private:
+    utils::rational current_time;
+    size_t compactions; // the number of compactions done before the snapshot..
+    cow_vector<indexed_atom> atoms; // the chunks of the copy-on-write containers are shared with the executor..
+    std::shared_ptr<const std::vector<const ratio::atom *>> executing;
+    cow_vector<size_t> ended_atoms;
+    cow_vector<std::shared_ptr<const atom_adaptation>> adaptations;
+    cow_sequence<pulse> pulses;
   };
 
   class execution_exception : public std::exception
@@ -196,6 +616,37 @@ namespace ratio::executor
     }
   }
 
+#ifdef LATENCY_HISTOGRAMS
+  inline std::string to_string(latency_phase phase) noexcept
+  {
+    switch (phase)
+    {
+    case TickPhase:
+      return "tick";
+    case SolvePhase:
+      return "solve";
+    case NotifyPhase:
+      return "notify";
+    case DelayPhase:
+      return "delay";
+    case FreezePhase:
+      return "freeze";
+    case DispatchPhase:
+      return "dispatch";
+    case AdaptPhase:
+      return "adapt";
+    case FailurePhase:
+      return "failure";
+    case TimelinesPhase:
+      return "timelines";
+    case PropagatePhase:
+      return "propagate";
+    default:
+      return "unknown";
+    }
+  }
+#endif
+
   inline json::json new_solver_message(const executor &exec) { return {{"type", "new_solver"}, {"id", get_id(exec.get_solver())}, {"name", exec.get_name()}, {"state", to_string(exec.get_state())}}; }
   inline json::json deleted_solver_message(const uintptr_t id) { return {{"type", "deleted_solver"}, {"id", id}}; }
 
@@ -237,7 +688,7 @@ namespace ratio::executor
     json::json j_sc = solver_state_changed_message(exec.get_solver());
     j_sc["time"] = ratio::to_json(exec.get_current_time());
     json::json j_executing(json::json_type::array);
-    for (const auto &atm : exec.get_executing())
+    for (const auto &atm : exec.get_executing_atoms())
       j_executing.push_back(get_id(*atm));
     j_sc["executing"] = std::move(j_executing);
     return j_sc;
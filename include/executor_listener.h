@@ -1,9 +1,15 @@
 #pragma once
 
 #include "executor.h"
+#include "executor_log.h"
 
 namespace ratio::executor
 {
+  /**
+   * @brief A listener of the execution of a plan.
+   *
+   * The notifications are delivered on the executing thread. With `MULTIPLE_EXECUTORS` and background replanning, the notifications received while `executor::is_replanning()` must not access the solver, which is being modified by the background thread.
+   */
   class executor_listener
   {
     friend class executor;
@@ -24,7 +30,7 @@ namespace ratio::executor
     /**
      * @brief Notifies the listener the passing of time.
      */
-    virtual void tick([[maybe_unused]] const utils::rational &time) { LOG("current time: " << to_string(time)); }
+    virtual void tick([[maybe_unused]] const utils::rational &time) { PLEXA_LOG_TRACE("current time: ", time); }
 
     /**
      * @brief Notifies the listener that some atoms are going to start.
@@ -56,6 +62,39 @@ namespace ratio::executor
      */
     virtual void end(const std::unordered_set<ratio::atom *> &) {}
 
+    /**
+     * @brief Notifies the listener that the starting of some atoms has been delayed.
+     *
+     * @param atoms the delayed atoms, together with their delays.
+     */
+    virtual void start_delayed(const std::unordered_map<const ratio::atom *, utils::rational> &) {}
+    /**
+     * @brief Notifies the listener that the ending of some atoms has been delayed.
+     *
+     * @param atoms the delayed atoms, together with their delays.
+     */
+    virtual void end_delayed(const std::unordered_map<const ratio::atom *, utils::rational> &) {}
+
+    /**
+     * @brief Notifies the listener that the execution of some atoms has failed.
+     *
+     * @param atoms the set of failed atoms.
+     */
+    virtual void failed(const std::unordered_set<const ratio::atom *> &) {}
+
+    /**
+     * @brief Notifies the listener that the plan is being adapted through the given script.
+     *
+     * @param script the RiDDLe script used for adapting the plan.
+     */
+    virtual void adapting(const std::string &) {}
+    /**
+     * @brief Notifies the listener that the plan is being adapted through the given files.
+     *
+     * @param files the RiDDLe files used for adapting the plan.
+     */
+    virtual void adapting(const std::vector<std::string> &) {}
+
   protected:
     executor &exec;
   };
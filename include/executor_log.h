@@ -0,0 +1,216 @@
+#pragma once
+
+#include "plexa_export.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#define PLEXA_LOG_LEVEL_OFF 0
+#define PLEXA_LOG_LEVEL_ERROR 1
+#define PLEXA_LOG_LEVEL_WARN 2
+#define PLEXA_LOG_LEVEL_INFO 3
+#define PLEXA_LOG_LEVEL_DEBUG 4
+#define PLEXA_LOG_LEVEL_TRACE 5
+
+#ifndef PLEXA_LOG_LEVEL
+#define PLEXA_LOG_LEVEL PLEXA_LOG_LEVEL_OFF
+#endif
+
+namespace ratio::executor::logging
+{
+  enum log_level
+  {
+    Error = PLEXA_LOG_LEVEL_ERROR,
+    Warn = PLEXA_LOG_LEVEL_WARN,
+    Info = PLEXA_LOG_LEVEL_INFO,
+    Debug = PLEXA_LOG_LEVEL_DEBUG,
+    Trace = PLEXA_LOG_LEVEL_TRACE
+  };
+
+  template <typename T, typename = void>
+  struct is_streamable : std::false_type
+  {
+  };
+  template <typename T>
+  struct is_streamable<T, std::void_t<decltype(std::declval<std::ostream &>() << std::declval<const T &>())>> : std::true_type
+  {
+  };
+
+  /**
+   * @brief Writes a logged argument, through its `operator<<` if any, or through its `to_string` function otherwise.
+   */
+  template <typename T>
+  void write(std::ostream &os, const T &val)
+  {
+    if constexpr (is_streamable<T>::value)
+      os << val;
+    else
+      os << to_string(val);
+  }
+
+  /**
+   * @brief A logger which formats and writes the messages on a background thread.
+   *
+   * The arguments of the messages are copied into the slots of a bounded, lock-free ring buffer, so that logging never formats nor blocks the logging thread, and allocates only for copying arguments which allocate themselves (e.g., `std::string`s). Messages logged while the ring buffer is full are dropped and counted. C strings are copied as pointers, hence only string literals, or strings which outlive the logger, should be logged as C strings.
+   */
+  class async_logger final
+  {
+    static constexpr size_t capacity = 4096; // the number of slots, a power of two..
+    static constexpr size_t payload_size = 96;
+
+    struct slot
+    {
+      std::atomic<size_t> seq;                     // the position the slot is ready for, as in Vyukov's bounded queues..
+      log_level lvl;                               // the level of the message..
+      void (*format)(std::ostream &, void *);      // formats and destroys the arguments of the message..
+      alignas(std::max_align_t) unsigned char args[payload_size]; // the arguments of the message..
+    };
+
+  public:
+    /**
+     * @brief Gets the logger, starting its background thread at the first call.
+     */
+    PLEXA_EXPORT static async_logger &get_instance();
+
+    async_logger(const async_logger &orig) = delete;
+    PLEXA_EXPORT ~async_logger();
+
+    /**
+     * @brief Sets the stream the messages are written to, `std::clog` by default. The stream is used by the background thread only.
+     *
+     * @param os the stream to write to.
+     */
+    void set_output(std::ostream &os) noexcept { out.store(&os, std::memory_order_release); }
+    /**
+     * @brief Gets the number of messages dropped so far because the ring buffer was full.
+     */
+    size_t get_dropped() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Enqueues a message, made of the concatenation of the given arguments, for being written by the background thread.
+     *
+     * @param lvl the level of the message.
+     * @param args the arguments of the message, copied into the ring buffer.
+     */
+    template <typename... Args>
+    void push(const log_level &lvl, Args &&...args) noexcept
+    {
+      using args_t = std::tuple<std::decay_t<Args>...>;
+      static_assert(sizeof(args_t) <= payload_size && alignof(args_t) <= alignof(std::max_align_t), "the arguments of the message are too large..");
+
+      size_t pos = tail.load(std::memory_order_relaxed);
+      slot *s;
+      while (true)
+      {
+        s = &slots[pos & (capacity - 1)];
+        const auto seq = s->seq.load(std::memory_order_acquire);
+        if (seq == pos)
+        { // the slot is free: we try to claim it..
+          if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+        }
+        else if (seq < pos)
+        { // the ring buffer is full..
+          dropped.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        else // another thread has claimed the slot..
+          pos = tail.load(std::memory_order_relaxed);
+      }
+
+      try
+      {
+        new (s->args) args_t(std::forward<Args>(args)...);
+        s->format = [](std::ostream &os, void *p)
+        {
+          auto c_args = static_cast<args_t *>(p);
+          std::apply([&os](const auto &...vals)
+                     { (logging::write(os, vals), ...); },
+                     *c_args);
+          c_args->~args_t();
+        };
+      }
+      catch (...)
+      { // copying the arguments failed: we still publish the slot, as an empty message..
+        s->format = nullptr;
+      }
+      s->lvl = lvl;
+      s->seq.store(pos + 1, std::memory_order_release);
+      if (!((pos + 1) & (capacity / 2 - 1))) // we wake the background thread before the ring buffer fills up..
+        cv.notify_one();
+    }
+
+  private:
+    async_logger();
+
+    bool consume(std::ostream &os);
+    void run();
+
+  private:
+    std::unique_ptr<slot[]> slots;
+    alignas(64) std::atomic<size_t> tail = 0; // the next position to be claimed by the producers..
+    alignas(64) size_t head = 0;              // the next position to be consumed by the background thread..
+    std::atomic<size_t> dropped = 0;
+    std::atomic<std::ostream *> out;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::thread th;
+  };
+
+  inline const char *to_string(const log_level &lvl) noexcept
+  {
+    switch (lvl)
+    {
+    case Error:
+      return "ERROR";
+    case Warn:
+      return "WARN";
+    case Info:
+      return "INFO";
+    case Debug:
+      return "DEBUG";
+    case Trace:
+      return "TRACE";
+    default:
+      return "UNKNOWN";
+    }
+  }
+} // namespace ratio::executor::logging
+
+#define PLEXA_LOG(lvl, ...) ratio::executor::logging::async_logger::get_instance().push(lvl, __VA_ARGS__)
+
+#if PLEXA_LOG_LEVEL >= PLEXA_LOG_LEVEL_ERROR
+#define PLEXA_LOG_ERROR(...) PLEXA_LOG(ratio::executor::logging::Error, __VA_ARGS__)
+#else
+#define PLEXA_LOG_ERROR(...) ((void)0)
+#endif
+#if PLEXA_LOG_LEVEL >= PLEXA_LOG_LEVEL_WARN
+#define PLEXA_LOG_WARN(...) PLEXA_LOG(ratio::executor::logging::Warn, __VA_ARGS__)
+#else
+#define PLEXA_LOG_WARN(...) ((void)0)
+#endif
+#if PLEXA_LOG_LEVEL >= PLEXA_LOG_LEVEL_INFO
+#define PLEXA_LOG_INFO(...) PLEXA_LOG(ratio::executor::logging::Info, __VA_ARGS__)
+#else
+#define PLEXA_LOG_INFO(...) ((void)0)
+#endif
+#if PLEXA_LOG_LEVEL >= PLEXA_LOG_LEVEL_DEBUG
+#define PLEXA_LOG_DEBUG(...) PLEXA_LOG(ratio::executor::logging::Debug, __VA_ARGS__)
+#else
+#define PLEXA_LOG_DEBUG(...) ((void)0)
+#endif
+#if PLEXA_LOG_LEVEL >= PLEXA_LOG_LEVEL_TRACE
+#define PLEXA_LOG_TRACE(...) PLEXA_LOG(ratio::executor::logging::Trace, __VA_ARGS__)
+#else
+#define PLEXA_LOG_TRACE(...) ((void)0)
+#endif
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "executor.h"
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <exception>
+
+namespace ratio::executor
+{
+  /**
+   * @brief A scheduler which drives the ticks of many executors over a fixed pool of worker threads.
+   *
+   * Each executor has its own tick duration, and hence its own deadline for the next tick. Each worker keeps the executors it has last ticked in a deadline-ordered heap and, when none of them is due, steals the most urgent due executor from the other workers. An executor is ticked by at most one worker at a time, and the ticks missed because of a late worker are coalesced into a single `tick(n)` call. After each tick the scheduler sleeps through the idle ticks of the executor, so `wake` should be called whenever the plan changes (e.g., after an `adapt`).
+   *
+   * The executors are ticked, and notify their listeners, on the worker threads. Executors which are also accessed from other threads require `MULTIPLE_EXECUTORS`.
+   */
+  class executor_scheduler final
+  {
+    using clock = std::chrono::steady_clock;
+
+    struct job
+    {
+      job(executor &exec, const std::chrono::nanoseconds &tick_dur, const clock::time_point &next) : exec(exec), tick_duration(tick_dur), next_tick(next) {}
+
+      executor &exec;
+      const std::chrono::nanoseconds tick_duration; // the duration of each tick..
+      std::recursive_mutex mtx;                     // held while ticking the executor, so that listeners can wake or remove it..
+      clock::time_point next_tick;                  // the time of the first tick not yet performed..
+      size_t generation = 0;                        // incremented whenever the job is rescheduled, invalidating the previous entries..
+      bool removed = false;
+    };
+
+    struct entry
+    {
+      clock::time_point deadline;
+      std::shared_ptr<job> jb;
+      size_t generation;
+
+      bool operator>(const entry &other) const { return deadline > other.deadline; }
+    };
+
+    struct worker
+    {
+      std::mutex mtx;
+      std::vector<entry> heap; // the min-heap of the scheduled executors, by deadline..
+      std::thread th;
+    };
+
+  public:
+    /**
+     * @brief Construct a new executor scheduler object and starts its worker threads.
+     *
+     * @param workers the number of worker threads.
+     * @param on_error the function called, on a worker thread, when ticking an executor throws. The executor is removed from the scheduler.
+     */
+    PLEXA_EXPORT executor_scheduler(const size_t &workers = std::max(std::thread::hardware_concurrency(), 1u), std::function<void(executor &, std::exception_ptr)> on_error = nullptr);
+    executor_scheduler(const executor_scheduler &that) = delete;
+    PLEXA_EXPORT ~executor_scheduler();
+
+    /**
+     * @brief Adds an executor to the scheduler, ticking it every `tick_dur`.
+     *
+     * @param exec the executor to tick.
+     * @param tick_dur the duration of each tick.
+     */
+    PLEXA_EXPORT void add(executor &exec, const std::chrono::nanoseconds &tick_dur);
+    /**
+     * @brief Removes an executor from the scheduler, waiting for its current tick, if any, to complete.
+     *
+     * @param exec the executor to remove.
+     */
+    PLEXA_EXPORT void remove(executor &exec);
+    /**
+     * @brief Interrupts the sleep of an executor through its idle ticks, making it due at its next tick.
+     *
+     * @param exec the executor to wake.
+     */
+    PLEXA_EXPORT void wake(executor &exec);
+
+    /**
+     * @brief Stops the worker threads. The executors are not ticked anymore.
+     */
+    PLEXA_EXPORT void stop();
+
+  private:
+    void schedule(const std::shared_ptr<job> &jb, const clock::time_point &deadline, const size_t &generation, const size_t &w);
+    void work(const size_t &w);
+    bool next_entry(const size_t &w, entry &e);
+    void run(const entry &e, const size_t &w);
+
+  private:
+    std::function<void(executor &, std::exception_ptr)> on_error;
+    std::mutex mtx;                                                  // protects the jobs..
+    std::unordered_map<const executor *, std::shared_ptr<job>> jobs; // the scheduled executors..
+    std::vector<std::unique_ptr<worker>> workers;
+    size_t next_worker = 0;            // the worker receiving the next added or woken executor..
+    std::mutex sleep_mtx;              // protects the sleep of the idle workers..
+    std::condition_variable sleep_cv;  // notified whenever a new entry is scheduled..
+    std::atomic<bool> stopping = false;
+  };
+} // namespace ratio::executor
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+namespace ratio::executor
+{
+  /**
+   * @brief A lock-free histogram of latencies, in nanoseconds, with logarithmic buckets.
+   *
+   * As in HDR histograms, each power of two is split into `sub_buckets / 2` linear buckets, so that the recorded values are kept with a relative error below 1/16 across the whole 64 bits range. Recording a value takes a few relaxed atomic increments, hence the histogram can be read, e.g., for being dumped, while another thread records into it.
+   */
+  class latency_histogram final
+  {
+    static constexpr unsigned sub_bucket_bits = 5;
+    static constexpr uint64_t sub_buckets = uint64_t(1) << sub_bucket_bits;
+    static constexpr size_t bucket_count = (64 - sub_bucket_bits + 2) * (sub_buckets / 2);
+
+  public:
+    latency_histogram() = default;
+    latency_histogram(const latency_histogram &orig) = delete;
+
+    /**
+     * @brief Records a latency.
+     *
+     * @param ns the latency, in nanoseconds.
+     */
+    void record(const uint64_t &ns) noexcept
+    {
+      counts[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+      count.fetch_add(1, std::memory_order_relaxed);
+      sum.fetch_add(ns, std::memory_order_relaxed);
+      auto c_min = min.load(std::memory_order_relaxed);
+      while (ns < c_min && !min.compare_exchange_weak(c_min, ns, std::memory_order_relaxed))
+        ;
+      auto c_max = max.load(std::memory_order_relaxed);
+      while (ns > c_max && !max.compare_exchange_weak(c_max, ns, std::memory_order_relaxed))
+        ;
+    }
+
+    /**
+     * @brief Gets the number of recorded latencies.
+     */
+    uint64_t get_count() const noexcept { return count.load(std::memory_order_relaxed); }
+    /**
+     * @brief Gets the smallest recorded latency, in nanoseconds, or zero if nothing has been recorded.
+     */
+    uint64_t get_min() const noexcept { return get_count() ? min.load(std::memory_order_relaxed) : 0; }
+    /**
+     * @brief Gets the largest recorded latency, in nanoseconds.
+     */
+    uint64_t get_max() const noexcept { return max.load(std::memory_order_relaxed); }
+    /**
+     * @brief Gets the mean of the recorded latencies, in nanoseconds.
+     */
+    double get_mean() const noexcept
+    {
+      const auto c = get_count();
+      return c ? static_cast<double>(sum.load(std::memory_order_relaxed)) / static_cast<double>(c) : 0;
+    }
+    /**
+     * @brief Gets the latency below which the given fraction of the recorded latencies lies.
+     *
+     * @param q the fraction, between 0 and 1 (e.g., 0.99 for the 99th percentile).
+     * @return uint64_t the highest value equivalent to the bucket of the percentile, in nanoseconds, capped at the largest recorded latency.
+     */
+    uint64_t get_percentile(const double &q) const noexcept
+    {
+      const auto c = get_count();
+      if (!c)
+        return 0;
+      const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(c) + 0.5));
+      uint64_t seen = 0;
+      for (size_t i = 0; i < bucket_count; ++i)
+        if ((seen += counts[i].load(std::memory_order_relaxed)) >= target)
+          return std::min(upper_bound(i), get_max());
+      return get_max();
+    }
+
+    /**
+     * @brief Forgets the recorded latencies. Latencies recorded concurrently with the reset might be partially forgotten.
+     */
+    void reset() noexcept
+    {
+      for (auto &c : counts)
+        c.store(0, std::memory_order_relaxed);
+      count.store(0, std::memory_order_relaxed);
+      sum.store(0, std::memory_order_relaxed);
+      min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+      max.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Writes the non-empty buckets, one per line, as the highest value equivalent to the bucket, in nanoseconds, followed by the number of latencies recorded into it.
+     *
+     * @param os the stream to write to.
+     */
+    void dump(std::ostream &os) const
+    {
+      for (size_t i = 0; i < bucket_count; ++i)
+        if (const auto c = counts[i].load(std::memory_order_relaxed))
+          os << upper_bound(i) << ' ' << c << '\n';
+    }
+
+  private:
+    static size_t bucket_of(const uint64_t &ns) noexcept
+    {
+      if (ns < sub_buckets)
+        return static_cast<size_t>(ns);
+      unsigned msb = 0;
+      for (auto v = ns; v >>= 1;)
+        ++msb;
+      const unsigned shift = msb - (sub_bucket_bits - 1);
+      return static_cast<size_t>(shift * (sub_buckets / 2) + (ns >> shift));
+    }
+    static uint64_t upper_bound(const size_t &i) noexcept
+    {
+      if (i < sub_buckets)
+        return i;
+      const unsigned shift = static_cast<unsigned>(i / (sub_buckets / 2) - 1);
+      const uint64_t mantissa = i - shift * (sub_buckets / 2);
+      return ((mantissa + 1) << shift) - 1;
+    }
+
+  private:
+    std::array<std::atomic<uint64_t>, bucket_count> counts = {};
+    std::atomic<uint64_t> count = 0, sum = 0;
+    std::atomic<uint64_t> min = std::numeric_limits<uint64_t>::max(), max = 0;
+  };
+
+  /**
+   * @brief Records, when destroyed, the time elapsed since its construction into a latency histogram.
+   */
+  class latency_timer final
+  {
+  public:
+    explicit latency_timer(latency_histogram &hist) noexcept : hist(hist), start(std::chrono::steady_clock::now()) {}
+    latency_timer(const latency_timer &orig) = delete;
+    ~latency_timer() { hist.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count())); }
+
+  private:
+    latency_histogram &hist;
+    const std::chrono::steady_clock::time_point start;
+  };
+} // namespace ratio::executor
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace ratio::executor
+{
+  /**
+   * @brief A memory arena which carves the small blocks out of large chunks, recycling the deallocated blocks through per-size free lists.
+   *
+   * The blocks never move, and the chunks are returned to the system all at once when the arena is destroyed. Blocks larger than `max_block_size` are delegated to the global allocator. The arena is not thread-safe.
+   */
+  class memory_arena final
+  {
+    static constexpr size_t granularity = alignof(std::max_align_t);
+    static constexpr size_t max_block_size = 1024;
+
+  public:
+    /**
+     * @brief Construct a new memory arena object.
+     *
+     * @param chunk_size the size of the chunks requested to the system.
+     */
+    explicit memory_arena(const size_t &chunk_size = 64 * 1024) : chunk_size(std::max(chunk_size, max_block_size)), free_lists(max_block_size / granularity, nullptr) {}
+    memory_arena(const memory_arena &orig) = delete;
+    ~memory_arena()
+    {
+      for (const auto &chunk : chunks)
+        ::operator delete(chunk);
+    }
+
+    /**
+     * @brief Allocates a block of the given size, aligned at most as `std::max_align_t`.
+     *
+     * @param size the size of the block.
+     * @return void* the allocated block.
+     */
+    void *allocate(const size_t &size)
+    {
+      if (size > max_block_size || !size)
+        return ::operator new(size);
+      auto &free_list = free_lists[(size - 1) / granularity];
+      if (free_list)
+      { // we recycle a deallocated block..
+        auto blk = free_list;
+        free_list = *static_cast<void **>(blk);
+        return blk;
+      }
+      const auto blk_size = ((size - 1) / granularity + 1) * granularity;
+      if (static_cast<size_t>(end - cur) < blk_size)
+      { // we need a new chunk..
+        cur = static_cast<std::byte *>(::operator new(chunk_size));
+        end = cur + chunk_size;
+        chunks.push_back(cur);
+      }
+      auto blk = cur;
+      cur += blk_size;
+      return blk;
+    }
+
+    /**
+     * @brief Deallocates a block previously allocated through this arena.
+     *
+     * @param blk the block to deallocate.
+     * @param size the size of the block.
+     */
+    void deallocate(void *blk, const size_t &size) noexcept
+    {
+      if (size > max_block_size || !size)
+        return ::operator delete(blk);
+      auto &free_list = free_lists[(size - 1) / granularity];
+      *static_cast<void **>(blk) = free_list;
+      free_list = blk;
+    }
+
+    /**
+     * @brief Gets the number of bytes requested to the system for the chunks.
+     *
+     * @return size_t the number of bytes of the chunks.
+     */
+    size_t get_reserved() const noexcept { return chunks.size() * chunk_size; }
+
+  private:
+    const size_t chunk_size;
+    std::vector<void *> free_lists; // for each size class, the deallocated blocks..
+    std::vector<std::byte *> chunks;
+    std::byte *cur = nullptr, *end = nullptr; // the free space of the current chunk..
+  };
+
+  /**
+   * @brief A standard allocator which allocates from a memory arena.
+   *
+   * Copies of containers select the global allocator, so that the copies (e.g., the snapshots) can outlive, or be released on another thread than, the arena.
+   *
+   * @tparam T the type of the allocated elements.
+   */
+  template <typename T>
+  class arena_allocator
+  {
+    template <typename U>
+    friend class arena_allocator;
+
+  public:
+    using value_type = T;
+
+    arena_allocator() noexcept = default;
+    explicit arena_allocator(memory_arena &arena) noexcept : arena(&arena) {}
+    template <typename U>
+    arena_allocator(const arena_allocator<U> &other) noexcept : arena(other.arena) {}
+
+    T *allocate(const size_t &n)
+    {
+      static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported..");
+      return static_cast<T *>(arena ? arena->allocate(n * sizeof(T)) : ::operator new(n * sizeof(T)));
+    }
+    void deallocate(T *p, const size_t &n) noexcept
+    {
+      if (arena)
+        arena->deallocate(p, n * sizeof(T));
+      else
+        ::operator delete(p);
+    }
+
+    arena_allocator select_on_container_copy_construction() const noexcept { return arena_allocator(); }
+
+    template <typename U>
+    bool operator==(const arena_allocator<U> &other) const noexcept { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const arena_allocator<U> &other) const noexcept { return arena != other.arena; }
+
+  private:
+    memory_arena *arena = nullptr; // the arena, or `nullptr` for the global allocator..
+  };
+} // namespace ratio::executor
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "executor_listener.h"
+#include <string_view>
+#include <functional>
+
+namespace ratio::executor
+{
+  /**
+   * @brief A writer which serializes the executor messages directly into a reusable buffer, without building the intermediate JSON trees.
+   *
+   * The produced messages are equivalent to the ones returned by the corresponding `*_message` functions.
+   */
+  class message_writer final
+  {
+  public:
+    /**
+     * @brief Gets the serialized message.
+     *
+     * @return std::string_view the serialized message, valid until the next write.
+     */
+    std::string_view str() const { return buffer; }
+
+    PLEXA_EXPORT std::string_view executor_state_changed(const executor &exec);
+    PLEXA_EXPORT std::string_view tick(const executor &exec, const utils::rational &time);
+    PLEXA_EXPORT std::string_view starting(const executor &exec, const std::unordered_set<ratio::atom *> &atoms);
+    PLEXA_EXPORT std::string_view start(const executor &exec, const std::unordered_set<ratio::atom *> &atoms);
+    PLEXA_EXPORT std::string_view ending(const executor &exec, const std::unordered_set<ratio::atom *> &atoms);
+    PLEXA_EXPORT std::string_view end(const executor &exec, const std::unordered_set<ratio::atom *> &atoms);
+
+  private:
+    void begin(const char *type, const executor &exec);
+    void write_atoms(const char *key, const std::unordered_set<ratio::atom *> &atoms);
+    void write(const utils::rational &r);
+    template <typename T>
+    void write(T val);
+
+  private:
+    std::string buffer; // the reusable buffer, cleared but never shrunk..
+  };
+
+  /**
+   * @brief An executor listener which serializes each notification once and fans the resulting bytes out to all its subscribers.
+   */
+  class message_broadcaster : public executor_listener
+  {
+  public:
+    using subscriber = std::function<void(std::string_view)>;
+
+    message_broadcaster(executor &e) : executor_listener(e) {}
+
+    /**
+     * @brief Adds a subscriber which receives every serialized message.
+     *
+     * @param s the subscriber.
+     */
+    void subscribe(subscriber s) { subscribers.push_back(std::move(s)); }
+
+  private:
+    void executor_state_changed(executor_state) override { broadcast(writer.executor_state_changed(exec)); }
+    void tick(const utils::rational &time) override { broadcast(writer.tick(exec, time)); }
+    void starting(const std::unordered_set<ratio::atom *> &atoms) override { broadcast(writer.starting(exec, atoms)); }
+    void start(const std::unordered_set<ratio::atom *> &atoms) override { broadcast(writer.start(exec, atoms)); }
+    void ending(const std::unordered_set<ratio::atom *> &atoms) override { broadcast(writer.ending(exec, atoms)); }
+    void end(const std::unordered_set<ratio::atom *> &atoms) override { broadcast(writer.end(exec, atoms)); }
+
+    void broadcast(std::string_view msg)
+    {
+      for (const auto &s : subscribers)
+        s(msg);
+    }
+
+  private:
+    message_writer writer;
+    std::vector<subscriber> subscribers;
+  };
+} // namespace ratio::executor
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace ratio::executor
+{
+  /**
+   * @brief A lock-free, multiple-producer single-consumer queue.
+   *
+   * Producers push their elements onto an atomic stack, while the consumer grabs the whole stack at once and reverses it, so that the elements are consumed in the order they have been pushed.
+   *
+   * @tparam T the type of the elements.
+   */
+  template <typename T>
+  class mpsc_queue final
+  {
+    struct node
+    {
+      T val;
+      node *next;
+    };
+
+  public:
+    mpsc_queue() = default;
+    mpsc_queue(const mpsc_queue &orig) = delete;
+    ~mpsc_queue() { clear(head.exchange(nullptr, std::memory_order_acquire)); }
+
+    /**
+     * @brief Pushes a new element into the queue. This method can be safely called by any thread.
+     *
+     * @param val the element to push.
+     */
+    void push(T val)
+    {
+      auto n = new node{std::move(val), head.load(std::memory_order_relaxed)};
+      while (!head.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed))
+        ;
+    }
+
+    /**
+     * @brief Checks whether the queue is empty.
+     *
+     * @return true if the queue is empty.
+     * @return false if the queue has some elements.
+     */
+    bool empty() const { return head.load(std::memory_order_acquire) == nullptr; }
+
+    /**
+     * @brief Consumes all the elements in the queue, in the order they have been pushed. This method must be called by the consumer thread only.
+     *
+     * If `f` throws, the element which caused the exception is discarded, while the elements not yet consumed are put back into the queue, before the ones pushed in the meanwhile, so that the next call consumes them in their original order.
+     *
+     * @param f the function to call on each element.
+     */
+    template <typename F>
+    void drain(F f)
+    {
+      node *c_node = nullptr;
+      for (auto n = head.exchange(nullptr, std::memory_order_acquire); n;)
+      { // we reverse the stack..
+        auto next = n->next;
+        n->next = c_node;
+        c_node = n;
+        n = next;
+      }
+      while (c_node)
+      {
+        auto next = c_node->next;
+        try
+        {
+          f(std::move(c_node->val));
+        }
+        catch (...)
+        {
+          delete c_node;
+          restore(next);
+          throw;
+        }
+        delete c_node;
+        c_node = next;
+      }
+    }
+
+  private:
+    /**
+     * @brief Puts back the given elements, in the order they have been pushed, beneath the ones pushed in the meanwhile.
+     */
+    void restore(node *n)
+    {
+      if (!n)
+        return;
+      node *top = nullptr;
+      for (; n;)
+      { // we reverse the elements back into a stack..
+        auto next = n->next;
+        n->next = top;
+        top = n;
+        n = next;
+      }
+      auto h = head.load(std::memory_order_acquire);
+      while (!h)
+        if (head.compare_exchange_weak(h, top, std::memory_order_release, std::memory_order_acquire))
+          return;
+      // the producers never change the pushed nodes, hence the consumer can link the restored elements beneath the bottom one..
+      while (h->next)
+        h = h->next;
+      h->next = top;
+    }
+
+    static void clear(node *n)
+    {
+      while (n)
+      {
+        auto next = n->next;
+        delete n;
+        n = next;
+      }
+    }
+
+  private:
+    std::atomic<node *> head = nullptr;
+  };
+} // namespace ratio::executor
@@ -3,14 +3,82 @@
 #include <functional>
 #include <atomic>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 namespace ratio::time
 {
-  class timer final
+  /**
+   * @brief What to do with the ticks which have been missed because a call lasted longer than its tick.
+   */
+  enum overrun_policy
   {
+    Skip,    // the missed ticks are dropped..
+    Burst,   // the function is called, back to back, once for each missed tick..
+    Coalesce // the function is called once, with the number of elapsed ticks including the missed ones, which only counting functions are told..
+  };
+
+  struct timer_stats
+  {
+    size_t calls = 0;                                                        // the number of scheduled calls..
+    size_t jitter_samples = 0;                                               // the number of calls whose delay has been measured, excluding those following a wake..
+    size_t overruns = 0;                                                     // the number of times the calls lasted longer than their tick..
+    size_t missed_ticks = 0;                                                 // the number of ticks missed because of the overruns..
+    std::chrono::nanoseconds min_jitter = std::chrono::nanoseconds::max();   // the minimum delay of a call with respect to its schedule..
+    std::chrono::nanoseconds max_jitter = std::chrono::nanoseconds::zero();  // the maximum delay of a call with respect to its schedule..
+    std::chrono::nanoseconds total_jitter = std::chrono::nanoseconds::zero(); // the sum of the delays of the calls with respect to their schedule..
+
+    std::chrono::nanoseconds mean_jitter() const { return jitter_samples ? std::chrono::nanoseconds(total_jitter.count() / static_cast<std::chrono::nanoseconds::rep>(jitter_samples)) : std::chrono::nanoseconds::zero(); }
+  };
+
+  template <typename Clock>
+  class basic_timer final
+  {
+    using time_point = std::chrono::time_point<Clock, std::chrono::nanoseconds>;
+
   public:
-    timer(const size_t &tick_dur, std::function<void(void)> f);
-    ~timer() { stop(); }
+    /**
+     * @brief Construct a new timer object which calls `f` at each tick.
+     *
+     * Since `f` is not told the number of elapsed ticks, the `Coalesce` policy behaves as `Skip`: for coalescing the missed ticks, use the constructors taking a counting function, with an empty `idle` function.
+     *
+     * @param tick_dur the duration of each tick in milliseconds.
+     * @param f the function to call at each tick.
+     * @param policy what to do with the ticks missed because of the calls lasting longer than their tick.
+     */
+    basic_timer(const size_t &tick_dur, std::function<void(void)> f, const overrun_policy &policy = Burst);
+    /**
+     * @brief Construct a new timer object which calls `f` at each tick.
+     *
+     * As for the previous constructor, the `Coalesce` policy behaves as `Skip`.
+     *
+     * @param tick_dur the duration of each tick.
+     * @param f the function to call at each tick.
+     * @param policy what to do with the ticks missed because of the calls lasting longer than their tick.
+     */
+    basic_timer(const std::chrono::nanoseconds &tick_dur, std::function<void(void)> f, const overrun_policy &policy = Burst);
+    /**
+     * @brief Construct a new event-driven timer object.
+     *
+     * After each call to `f`, the timer asks `idle` how many of the following ticks can be skipped and sleeps through them. The function `f` is then called with the number of ticks elapsed since its previous call. The sleep can be interrupted through the `wake` method, e.g., when the skipped ticks are not idle anymore.
+     *
+     * @param tick_dur the duration of each tick in milliseconds.
+     * @param f the function to call, with the number of elapsed ticks.
+     * @param idle the function returning the number of ticks which can be skipped, or an empty function for calling `f` at each tick.
+     * @param policy what to do with the ticks missed because of the calls lasting longer than their tick.
+     */
+    basic_timer(const size_t &tick_dur, std::function<void(size_t)> f, std::function<size_t(void)> idle, const overrun_policy &policy = Burst);
+    /**
+     * @brief Construct a new event-driven timer object.
+     *
+     * @param tick_dur the duration of each tick.
+     * @param f the function to call, with the number of elapsed ticks.
+     * @param idle the function returning the number of ticks which can be skipped, or an empty function for calling `f` at each tick.
+     * @param policy what to do with the ticks missed because of the calls lasting longer than their tick.
+     */
+    basic_timer(const std::chrono::nanoseconds &tick_dur, std::function<void(size_t)> f, std::function<size_t(void)> idle, const overrun_policy &policy = Burst);
+    ~basic_timer() { stop(); }
 
     /**
      * @brief Starts the timer.
@@ -20,12 +88,43 @@ namespace ratio::time
      * @brief Stops the timer.
      */
     void stop();
+    /**
+     * @brief Interrupts the current sleep, asking again for the number of ticks which can be skipped.
+     */
+    void wake();
+
+    /**
+     * @brief Sets how long before each tick the timer stops sleeping and starts spinning, trading CPU for precision on short ticks. This method can be safely called while the timer is running.
+     *
+     * @param spin_dur the spinning duration.
+     */
+    void set_spin(const std::chrono::nanoseconds &spin_dur) { spin.store(spin_dur, std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the statistics on the calls done so far.
+     *
+     * @return timer_stats the statistics on the calls.
+     */
+    timer_stats get_stats() const;
 
   private:
-    const size_t tick_duration; // the duration of each tick in milliseconds..
-    std::function<void(void)> fun;
-    std::chrono::steady_clock::time_point tick_time;
-    std::atomic<bool> executing;
+    std::pair<size_t, size_t> wait();
+
+  private:
+    const std::chrono::nanoseconds tick_duration; // the duration of each tick..
+    std::function<void(size_t)> fun;
+    std::function<size_t(void)> idle;
+    const overrun_policy policy;
+    std::atomic<std::chrono::nanoseconds> spin = std::chrono::nanoseconds::zero(); // the spinning duration, read by the timer thread..
+    time_point tick_time; // the time of the tick following the last call..
+    std::atomic<bool> executing = false;
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    bool woken = false;
+    timer_stats stats;
     std::thread th;
   };
+
+  using timer = basic_timer<std::chrono::steady_clock>;
+  using realtime_timer = basic_timer<std::chrono::system_clock>;
 } // namespace ratio::time
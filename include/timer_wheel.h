@@ -0,0 +1,72 @@
+#pragma once
+
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+namespace ratio::time
+{
+  /**
+   * @brief A hierarchical timing wheel which multiplexes many one-shot and periodic callbacks onto a few threads.
+   *
+   * The timers are spread, round-robin, over a number of shards, each made of four wheels of 64 slots and driven by its own thread, covering about 16 million resolution ticks before the far timers are cascaded again. Scheduling and cancelling a timer take constant time. While the first wheel of a shard is empty, its thread sleeps until the next cascade rather than waking at each resolution tick.
+   *
+   * The callbacks are called on the thread of their shard, hence they should be short. Periodic timers are drift-free: the k-th expiration is computed, in nanoseconds, as the first one plus k periods, and only then rounded up to the resolution, so that periods which are not multiples of the resolution do not accumulate rounding errors.
+   */
+  class timer_wheel final
+  {
+    class shard;
+
+  public:
+    using timer_id = uint64_t;
+
+    /**
+     * @brief Construct a new timer wheel object and starts its threads.
+     *
+     * @param resolution the granularity of the timers.
+     * @param threads the number of threads, each driving its own shard of timers.
+     */
+    timer_wheel(const std::chrono::nanoseconds &resolution = std::chrono::milliseconds(1), const size_t &threads = 1);
+    timer_wheel(const timer_wheel &that) = delete;
+    ~timer_wheel();
+
+    /**
+     * @brief Schedules a one-shot callback.
+     *
+     * @param delay the delay after which `f` is called.
+     * @param f the callback.
+     * @return timer_id the identifier of the timer, for cancelling it.
+     */
+    timer_id schedule(const std::chrono::nanoseconds &delay, std::function<void(void)> f);
+    /**
+     * @brief Schedules a periodic callback.
+     *
+     * @param delay the delay after which `f` is called for the first time.
+     * @param period the period with which `f` is called afterwards.
+     * @param f the callback.
+     * @return timer_id the identifier of the timer, for cancelling it.
+     */
+    timer_id schedule(const std::chrono::nanoseconds &delay, const std::chrono::nanoseconds &period, std::function<void(void)> f);
+    /**
+     * @brief Cancels a timer. A callback which is being called is not interrupted.
+     *
+     * @param id the identifier of the timer.
+     * @return true if the timer was pending and has been cancelled.
+     * @return false if the timer has already expired or has already been cancelled.
+     */
+    bool cancel(const timer_id &id);
+
+    /**
+     * @brief Stops the threads. The pending timers are not called anymore.
+     */
+    void stop();
+
+  private:
+    const std::chrono::nanoseconds resolution;
+    std::vector<std::unique_ptr<shard>> shards;
+    std::atomic<size_t> next_shard = 0; // the shard receiving the next timer..
+  };
+} // namespace ratio::time
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "executor_listener.h"
+#include <cstdint>
+#include <memory>
+#include <limits>
+
+namespace ratio::executor
+{
+  /**
+   * @brief The layout of the execution traces.
+   *
+   * A trace starts with a fixed 32 bytes header: a 4 bytes magic, the format version as a 32 bits unsigned integer, the number of committed bytes (header included) and the offset of the last checkpoint record as 64 bits unsigned integers, followed by 8 reserved bytes. The header is followed by the records, each made of a type byte, the payload length as a 32 bits unsigned integer and the payload. All the integers are little-endian.
+   *
+   * Atoms are identified by the variable of their sigma literal, which is stable across runs of the same problem. Rationals are written as a pair of 64 bits signed integers (numerator and denominator). A checkpoint record contains the number of recorded ticks, the current time and the offset of the previous checkpoint record, allowing readers to walk the trace backwards without scanning it.
+   */
+  namespace trace
+  {
+    constexpr char magic[4] = {'P', 'X', 'T', 'R'};
+    constexpr uint32_t version = 1;
+    constexpr size_t header_size = 32;
+    constexpr size_t record_header_size = 5;
+
+    enum record_type : uint8_t
+    {
+      Tick = 1,       // the current time..
+      Start,          // the started atoms..
+      End,            // the ended atoms..
+      StartDelay,     // the atoms whose starting has been delayed, with their delays..
+      EndDelay,       // the atoms whose ending has been delayed, with their delays..
+      Failure,        // the failed atoms..
+      AdaptScript,    // the RiDDLe script used for adapting the plan..
+      AdaptFiles,     // the RiDDLe files used for adapting the plan..
+      Checkpoint      // the number of ticks, the current time and the offset of the previous checkpoint..
+    };
+
+    class mapped_file;
+  } // namespace trace
+
+  /**
+   * @brief An executor listener which records the execution events into an append-only, memory-mapped trace.
+   *
+   * Records are appended directly into the mapped file and committed by updating the size stored in the header, so that a reader never sees a partially written record, even if the process crashes. A checkpoint record is appended every `checkpoint_every` ticks. On platforms without `mmap` the trace is written through a buffered file, which is flushed at every checkpoint.
+   */
+  class trace_recorder final : public executor_listener
+  {
+  public:
+    /**
+     * @brief Construct a new trace recorder object.
+     *
+     * @param e the executor to record.
+     * @param path the path of the trace file, which is truncated if it exists.
+     * @param checkpoint_every the number of ticks between two checkpoint records.
+     * @throws std::runtime_error if the trace file cannot be created.
+     */
+    PLEXA_EXPORT trace_recorder(executor &e, const std::string &path, const size_t &checkpoint_every = 1000);
+    /**
+     * @brief Destroy the trace recorder object, appending a final checkpoint record.
+     *
+     * A failure in writing the final checkpoint is logged, rather than thrown: callers which need to know should call `checkpoint` before destroying the recorder.
+     */
+    PLEXA_EXPORT ~trace_recorder();
+
+    /**
+     * @brief Appends a checkpoint record and flushes the trace to disk.
+     *
+     * @throws std::runtime_error if the trace file cannot be extended or flushed.
+     */
+    PLEXA_EXPORT void checkpoint();
+
+  private:
+    void tick(const utils::rational &time) override;
+    void start(const std::unordered_set<ratio::atom *> &atoms) override;
+    void end(const std::unordered_set<ratio::atom *> &atoms) override;
+    void start_delayed(const std::unordered_map<const ratio::atom *, utils::rational> &atoms) override;
+    void end_delayed(const std::unordered_map<const ratio::atom *, utils::rational> &atoms) override;
+    void failed(const std::unordered_set<const ratio::atom *> &atoms) override;
+    void adapting(const std::string &script) override;
+    void adapting(const std::vector<std::string> &files) override;
+
+    void write_atoms(const trace::record_type &type, const std::unordered_set<ratio::atom *> &atoms);
+    void write_delays(const trace::record_type &type, const std::unordered_map<const ratio::atom *, utils::rational> &atoms);
+    void write_u32(uint32_t val);
+    void write_u64(uint64_t val);
+    void write_rational(const utils::rational &val);
+    void write_string(const std::string &val);
+    void commit(const trace::record_type &type);
+
+  private:
+    std::unique_ptr<trace::mapped_file> file;
+    const size_t checkpoint_every;
+    size_t ticks = 0;
+    utils::rational current_time;
+    uint64_t last_checkpoint = 0;
+    std::vector<uint8_t> record; // the reusable buffer for the record being written..
+  };
+
+  /**
+   * @brief An executor listener which replays a recorded trace on a fresh executor, as fast as possible.
+   *
+   * The executor must have read the same problem of the recorded one. Failures and adaptations are injected before the tick they have been recorded in, while delays are injected when the delayed atoms are notified as starting or ending. The atoms started and ended by the replayed executor are compared against the recorded ones, and the mismatching ticks are counted as divergences.
+   */
+  class trace_replayer final : public executor_listener
+  {
+  public:
+    /**
+     * @brief Construct a new trace replayer object.
+     *
+     * @param e the executor which replays the trace.
+     * @param path the path of the trace file.
+     * @throws std::invalid_argument if the trace file cannot be read or is not a valid trace.
+     */
+    PLEXA_EXPORT trace_replayer(executor &e, const std::string &path);
+
+    /**
+     * @brief Replays the trace, starting the execution if needed.
+     *
+     * @param max_ticks the maximum number of ticks to replay.
+     * @return size_t the number of replayed ticks.
+     * @throws std::invalid_argument if the trace refers to atoms unknown to the executor, or if a record is malformed (e.g., its counts or strings overrun its length).
+     */
+    PLEXA_EXPORT size_t replay(const size_t &max_ticks = std::numeric_limits<size_t>::max());
+
+    /**
+     * @brief Gets the number of ticks in which the replayed executor diverged from the recorded one.
+     *
+     * @return size_t the number of diverging ticks.
+     */
+    size_t get_divergences() const { return divergences; }
+
+  private:
+    void starting(const std::unordered_set<ratio::atom *> &atoms) override;
+    void start(const std::unordered_set<ratio::atom *> &atoms) override;
+    void ending(const std::unordered_set<ratio::atom *> &atoms) override;
+    void end(const std::unordered_set<ratio::atom *> &atoms) override;
+
+    const ratio::atom &get_atom(const uint64_t &id) const;
+
+  private:
+    std::vector<uint8_t> bytes;                                              // the committed bytes of the trace..
+    size_t pos = trace::header_size;                                         // the position of the next record..
+    size_t divergences = 0;                                                  // the number of diverging ticks..
+    std::unordered_map<uint64_t, const ratio::atom *> atoms;                 // the atoms seen so far, by id..
+    std::unordered_map<uint64_t, utils::rational> start_delays, end_delays;  // the delays of the current tick..
+    std::vector<uint64_t> recorded_starts, recorded_ends, replayed_starts, replayed_ends; // the atoms started and ended in the current tick..
+  };
+} // namespace ratio::executor
@@ -0,0 +1,111 @@
+#include "async_executor_listener.h"
+#include <cassert>
+
+namespace ratio::executor
+{
+    PLEXA_EXPORT async_executor_listener::async_executor_listener(executor &e, const size_t &capacity) : executor_listener(e), buffer(capacity ? capacity : 1) {}
+    PLEXA_EXPORT async_executor_listener::~async_executor_listener()
+    {
+        assert(!th.joinable() && "the derived listener should call `stop` in its destructor");
+        stop(); // the derived listener is already destroyed, but we cannot leave the thread running..
+    }
+
+    PLEXA_EXPORT void async_executor_listener::start()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (th.joinable())
+            return;
+        stopping = false;
+        th = std::thread(&async_executor_listener::dispatch, this);
+    }
+
+    PLEXA_EXPORT void async_executor_listener::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        not_empty.notify_one();
+        if (th.joinable())
+            th.join();
+    }
+
+    void async_executor_listener::executor_state_changed(executor_state state)
+    {
+        notification n;
+        n.type = notification::StateChanged;
+        n.state = state;
+        push(std::move(n));
+    }
+    void async_executor_listener::tick(const utils::rational &time)
+    {
+        notification n;
+        n.type = notification::Tick;
+        n.time = time;
+        push(std::move(n));
+    }
+    void async_executor_listener::start(const std::unordered_set<ratio::atom *> &atoms)
+    {
+        notification n;
+        n.type = notification::Start;
+        n.atoms = atoms;
+        push(std::move(n));
+    }
+    void async_executor_listener::end(const std::unordered_set<ratio::atom *> &atoms)
+    {
+        notification n;
+        n.type = notification::End;
+        n.atoms = atoms;
+        push(std::move(n));
+    }
+
+    void async_executor_listener::push(notification &&n)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (stopping)
+                return; // the listener thread is not consuming the notifications anymore..
+            // we wait for some room in the ring buffer..
+            not_full.wait(lock, [this]
+                          { return size < buffer.size(); });
+            buffer[(head + size) % buffer.size()] = std::move(n);
+            ++size;
+        }
+        not_empty.notify_one();
+    }
+
+    void async_executor_listener::dispatch()
+    {
+        while (true)
+        {
+            notification n;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                not_empty.wait(lock, [this]
+                               { return size || stopping; });
+                if (!size)
+                    return; // we are stopping and there are no more pending notifications..
+                n = std::move(buffer[head]);
+                head = (head + 1) % buffer.size();
+                --size;
+            }
+            not_full.notify_one();
+
+            switch (n.type)
+            {
+            case notification::StateChanged:
+                async_executor_state_changed(n.state);
+                break;
+            case notification::Tick:
+                async_tick(n.time);
+                break;
+            case notification::Start:
+                async_start(n.atoms);
+                break;
+            case notification::End:
+                async_end(n.atoms);
+                break;
+            }
+        }
+    }
+} // namespace ratio::executor
@@ -0,0 +1,170 @@
+#include "binary_writer.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace ratio::executor
+{
+    namespace wire
+    {
+        static bool read_varint(const uint8_t *&data, const uint8_t *end, uint64_t &val)
+        {
+            val = 0;
+            for (unsigned shift = 0; data != end && shift < 64; shift += 7)
+            {
+                const auto byte = *data++;
+                if (shift == 63 && byte > 1)
+                    return false; // the value does not fit in 64 bits..
+                val |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        PLEXA_EXPORT size_t decode(const uint8_t *data, const size_t &size, event &evt)
+        {
+            if (size < header_size)
+                return 0;
+            if (data[0] != magic || data[1] != version)
+                throw std::invalid_argument("invalid message header..");
+            const size_t length = static_cast<size_t>(data[4]) | static_cast<size_t>(data[5]) << 8 | static_cast<size_t>(data[6]) << 16 | static_cast<size_t>(data[7]) << 24;
+            if (size < header_size + length)
+                return 0;
+
+            const uint8_t *c_data = data + header_size;
+            const uint8_t *end = c_data + length;
+            uint64_t val;
+            if (!read_varint(c_data, end, val))
+                throw std::invalid_argument("invalid solver id..");
+            evt.type = static_cast<message_type>(data[2]);
+            evt.solver_id = static_cast<uintptr_t>(val);
+            evt.atoms.clear();
+            switch (evt.type)
+            {
+            case StateChanged:
+                if (c_data == end || *c_data > executor_state::Failed)
+                    throw std::invalid_argument("invalid executor state..");
+                evt.state = static_cast<executor_state>(*c_data++);
+                break;
+            case Tick:
+                if (!read_varint(c_data, end, val))
+                    throw std::invalid_argument("invalid time numerator..");
+                evt.num = static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+                if (!read_varint(c_data, end, val) || !val || val > static_cast<uint64_t>(INT64_MAX))
+                    throw std::invalid_argument("invalid time denominator..");
+                evt.den = static_cast<int64_t>(val);
+                break;
+            case Starting:
+            case Start:
+            case Ending:
+            case End:
+            {
+                uint64_t n_atoms;
+                if (!read_varint(c_data, end, n_atoms) || n_atoms > length)
+                    throw std::invalid_argument("invalid number of atoms..");
+                evt.atoms.reserve(static_cast<size_t>(n_atoms));
+                uintptr_t id = 0;
+                for (uint64_t i = 0; i < n_atoms; ++i)
+                {
+                    if (!read_varint(c_data, end, val))
+                        throw std::invalid_argument("invalid atom id..");
+                    id += static_cast<uintptr_t>(val);
+                    evt.atoms.push_back(id);
+                }
+                break;
+            }
+            default:
+                throw std::invalid_argument("invalid message type..");
+            }
+            return header_size + length;
+        }
+    } // namespace wire
+
+    PLEXA_EXPORT const std::vector<uint8_t> &binary_writer::executor_state_changed(const executor &exec)
+    {
+        begin(wire::StateChanged, exec);
+        buffer.push_back(static_cast<uint8_t>(exec.get_state()));
+        finish();
+        return buffer;
+    }
+
+    PLEXA_EXPORT const std::vector<uint8_t> &binary_writer::tick(const executor &exec, const utils::rational &time)
+    {
+        begin(wire::Tick, exec);
+        const auto num = static_cast<int64_t>(time.numerator());
+        write_varint((static_cast<uint64_t>(num) << 1) ^ static_cast<uint64_t>(num >> 63)); // zigzag encoding..
+        write_varint(static_cast<uint64_t>(time.denominator()));
+        finish();
+        return buffer;
+    }
+
+    PLEXA_EXPORT const std::vector<uint8_t> &binary_writer::starting(const executor &exec, const std::unordered_set<ratio::atom *> &atoms)
+    {
+        begin(wire::Starting, exec);
+        write_atoms(atoms);
+        finish();
+        return buffer;
+    }
+    PLEXA_EXPORT const std::vector<uint8_t> &binary_writer::start(const executor &exec, const std::unordered_set<ratio::atom *> &atoms)
+    {
+        begin(wire::Start, exec);
+        write_atoms(atoms);
+        finish();
+        return buffer;
+    }
+    PLEXA_EXPORT const std::vector<uint8_t> &binary_writer::ending(const executor &exec, const std::unordered_set<ratio::atom *> &atoms)
+    {
+        begin(wire::Ending, exec);
+        write_atoms(atoms);
+        finish();
+        return buffer;
+    }
+    PLEXA_EXPORT const std::vector<uint8_t> &binary_writer::end(const executor &exec, const std::unordered_set<ratio::atom *> &atoms)
+    {
+        begin(wire::End, exec);
+        write_atoms(atoms);
+        finish();
+        return buffer;
+    }
+
+    void binary_writer::begin(const wire::message_type &type, const executor &exec)
+    {
+        buffer.assign({wire::magic, wire::version, type, 0, 0, 0, 0, 0});
+        write_varint(get_id(exec.get_solver()));
+    }
+
+    void binary_writer::write_atoms(const std::unordered_set<ratio::atom *> &atoms)
+    {
+        ids.clear();
+        for (const auto &atm : atoms)
+            ids.push_back(get_id(*atm));
+        // sorting the ids allows to encode the (small) differences between consecutive ids..
+        std::sort(ids.begin(), ids.end());
+        write_varint(ids.size());
+        uintptr_t prev = 0;
+        for (const auto &id : ids)
+        {
+            write_varint(id - prev);
+            prev = id;
+        }
+    }
+
+    void binary_writer::write_varint(uint64_t val)
+    {
+        while (val >= 0x80)
+        {
+            buffer.push_back(static_cast<uint8_t>(val | 0x80));
+            val >>= 7;
+        }
+        buffer.push_back(static_cast<uint8_t>(val));
+    }
+
+    void binary_writer::finish()
+    { // we write the payload length in the header..
+        const auto length = static_cast<uint32_t>(buffer.size() - wire::header_size);
+        buffer[4] = static_cast<uint8_t>(length);
+        buffer[5] = static_cast<uint8_t>(length >> 8);
+        buffer[6] = static_cast<uint8_t>(length >> 16);
+        buffer[7] = static_cast<uint8_t>(length >> 24);
+    }
+} // namespace ratio::executor
@@ -1,19 +1,119 @@
 #include "executor.h"
 #include "executor_listener.h"
+#include "executor_log.h"
 #include "item.h"
 #include "atom_flaw.h"
 #include <chrono>
 #include <sstream>
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <fstream>
+#include <filesystem>
+#include <utility>
+
+#ifdef LATENCY_HISTOGRAMS
+#define LATENCY_CONCAT_(a, b) a##b
+#define LATENCY_CONCAT(a, b) LATENCY_CONCAT_(a, b)
+#define MEASURE_LATENCY(phase) const latency_timer LATENCY_CONCAT(latency_timer_, __LINE__)(latencies[phase])
+#else
+#define MEASURE_LATENCY(phase)
+#endif
 
 namespace ratio::executor
 {
-    PLEXA_EXPORT executor::executor(ratio::solver &slv, const std::string &name, const utils::rational &units_per_tick) : core_listener(slv), solver_listener(slv), theory(slv.get_sat_core_ptr()), name(name), units_per_tick(units_per_tick), xi(slv.get_sat_core().new_var())
+    constexpr char checkpoint_magic[4] = {'P', 'X', 'C', 'K'};
+    constexpr uint32_t checkpoint_version = 1;
+
+    static void write_uint(std::ostream &os, uint64_t val, const size_t &size)
+    {
+        char bytes[8];
+        for (size_t i = 0; i < size; ++i)
+            bytes[i] = static_cast<char>(val >> (8 * i));
+        os.write(bytes, static_cast<std::streamsize>(size));
+    }
+    static void write_rational(std::ostream &os, const utils::rational &val)
+    {
+        if (val == utils::rational::POSITIVE_INFINITY)
+            write_uint(os, 1, 1);
+        else if (val == utils::rational::NEGATIVE_INFINITY)
+            write_uint(os, 2, 1);
+        else
+        {
+            write_uint(os, 0, 1);
+            write_uint(os, static_cast<uint64_t>(static_cast<int64_t>(val.numerator())), 8);
+            write_uint(os, static_cast<uint64_t>(static_cast<int64_t>(val.denominator())), 8);
+        }
+    }
+    static void write_inf_rational(std::ostream &os, const utils::inf_rational &val)
+    {
+        write_rational(os, val.get_rational());
+        write_rational(os, val.get_infinitesimal());
+    }
+    static void write_string(std::ostream &os, const std::string &val)
+    {
+        write_uint(os, val.size(), 4);
+        os.write(val.data(), static_cast<std::streamsize>(val.size()));
+    }
+
+    static uint64_t read_uint(std::istream &is, const size_t &size)
+    {
+        unsigned char bytes[8];
+        if (!is.read(reinterpret_cast<char *>(bytes), static_cast<std::streamsize>(size)))
+            throw std::invalid_argument("truncated checkpoint..");
+        uint64_t val = 0;
+        for (size_t i = 0; i < size; ++i)
+            val |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        return val;
+    }
+    static utils::rational read_rational(std::istream &is)
+    {
+        switch (read_uint(is, 1))
+        {
+        case 0:
+        {
+            const auto num = static_cast<int64_t>(read_uint(is, 8));
+            const auto den = static_cast<int64_t>(read_uint(is, 8));
+            if (den <= 0)
+                throw std::invalid_argument("invalid rational in checkpoint..");
+            return utils::rational(num, den);
+        }
+        case 1:
+            return utils::rational::POSITIVE_INFINITY;
+        case 2:
+            return utils::rational::NEGATIVE_INFINITY;
+        default:
+            throw std::invalid_argument("invalid rational in checkpoint..");
+        }
+    }
+    static utils::inf_rational read_inf_rational(std::istream &is)
+    {
+        const auto rat = read_rational(is);
+        const auto inf = read_rational(is);
+        return utils::inf_rational(rat, inf);
+    }
+    static std::string read_string(std::istream &is)
+    {
+        std::string val(static_cast<size_t>(read_uint(is, 4)), '\0');
+        if (!is.read(val.data(), static_cast<std::streamsize>(val.size())))
+            throw std::invalid_argument("truncated checkpoint..");
+        return val;
+    }
+
+    PLEXA_EXPORT executor::executor(ratio::solver &slv, const std::string &name, const utils::rational &units_per_tick) : core_listener(slv), solver_listener(slv), theory(slv.get_sat_core_ptr()), lra_value_listener(slv.get_lra_theory()), name(name), units_per_tick(units_per_tick), xi(slv.get_sat_core().new_var())
     {
         bind(variable(xi));
         build_timelines();
     }
 
+    PLEXA_EXPORT executor::~executor()
+    {
+#ifdef MULTIPLE_EXECUTORS
+        if (replanner.joinable()) // we wait for the background thread, which is using the solver..
+            replanner.join();
+#endif
+    }
+
     PLEXA_EXPORT void executor::start_execution()
     {
         running = true;
@@ -35,236 +135,1024 @@ namespace ratio::executor
 #ifdef MULTIPLE_EXECUTORS
         const std::lock_guard<std::mutex> lock(mtx);
 #endif
+        MEASURE_LATENCY(TickPhase);
+#ifdef MULTIPLE_EXECUTORS
+        if (replanning && replanned.load(std::memory_order_acquire))
+            finish_replanning(); // we swap in the new plan..
+        if (!replanning)
+        { // we apply the requests coming from other threads..
+            commands.drain([](std::function<void()> &&cmd)
+                           { cmd(); });
+            delay_requests.drain([](std::function<void()> &&cmd)
+                                 { cmd(); });
+        }
+        if (pending_requirements && plan_captured)
+            start_replanning();
+#endif
+        PLEXA_LOG_TRACE("current time: ", current_time);
+
+    manage_tick:
         if (pending_requirements)
         { // we solve the problem again..
-            slv.solve();
+            MEASURE_LATENCY(SolvePhase);
+            solve_pending_requirements();
             pending_requirements = false;
         }
 
         if (!running)
             return;
 
-        LOG("current time: " << to_string(current_time));
-
-    manage_tick:
-        while (!pulses.empty() && *pulses.cbegin() <= current_time)
+        while (!pulses.empty() && pulses.back().time <= current_time)
         { // we have something to do..
-            if (const auto starting_atms = s_atms.find(*pulses.cbegin()); starting_atms != s_atms.cend())
+            // the listeners might change the plan (e.g., through a failure), hence the pulse is looked up again at each notification..
+            const auto c_timelines_changes = timelines_changes;
+            const auto plan_changed = [this, &c_timelines_changes]()
+            { return pending_requirements || c_timelines_changes != timelines_changes; };
+            {
+                MEASURE_LATENCY(NotifyPhase);
                 // we notify that some atoms might be starting their execution..
                 for (const auto &l : listeners)
-                    l->starting(starting_atms->second);
-            if (const auto ending_atms = e_atms.find(*pulses.cbegin()); ending_atms != e_atms.cend())
+                    if (plan_changed())
+                        goto manage_tick;
+                    else if (!pulses.back().starting.empty())
+                        l->starting(pulses.back().starting);
                 // we notify that some atoms might be ending their execution..
                 for (const auto &l : listeners)
-                    l->ending(ending_atms->second);
+                    if (plan_changed())
+                        goto manage_tick;
+                    else if (!pulses.back().ending.empty())
+                        l->ending(pulses.back().ending);
+                if (plan_changed())
+                    goto manage_tick;
+#ifdef MULTIPLE_EXECUTORS
+                // only the delays are applied within the pulse, the other requests might change the timelines and are applied at the next tick..
+                if (replanning && !delay_requests.empty())
+                { // the delays might change the plan: we wait for the new one..
+                    finish_replanning();
+                    delay_requests.drain([](std::function<void()> &&cmd)
+                                         { cmd(); });
+                    goto manage_tick;
+                }
+                // we apply the delays requested by the listeners, unless the background thread owns the solver..
+                if (!replanning)
+                    delay_requests.drain([](std::function<void()> &&cmd)
+                                         { cmd(); });
+#endif
+            }
+
+#ifdef MULTIPLE_EXECUTORS
+            if (replanning)
+            { // the solver is busy: we dispatch the captured plan, deferring the freezing of the atoms to the swap..
+                MEASURE_LATENCY(DispatchPhase);
+                const auto c_pulse = pulses.take_back();
+                if (!c_pulse.starting.empty())
+                {
+                    dispatched.emplace_back(true, c_pulse.starting);
+                    for (const auto &l : listeners)
+                        l->start(c_pulse.starting);
+                }
+                if (!c_pulse.ending.empty())
+                {
+                    dispatched.emplace_back(false, c_pulse.ending);
+                    for (const auto &l : listeners)
+                        l->end(c_pulse.ending);
+                }
+                continue;
+            }
+#endif
 
-            bool delays = false;
-            if (const auto starting_atms = s_atms.find(*pulses.cbegin()); starting_atms != s_atms.cend())
-                for (const auto &atm : starting_atms->second)
-                    if (const auto at_atm = dont_start.find(atm); at_atm != dont_start.end())
+            // we collect the delays of the atoms which are not ready to start (end) yet..
+            std::vector<atom_delay> delays;
+            {
+                MEASURE_LATENCY(DelayPhase);
+                for (const auto &atm : pulses.back().starting)
+                    if (const auto idx = index_of(*atm); atoms[idx].start_delay)
                     { // this starting atom is not ready to be started..
-                        auto &xpr = slv.is_impulse(*atm) ? atm->get(RATIO_AT) : atm->get(RATIO_START);
-                        if (slv.is_constant(xpr))
-                            throw execution_exception(); // we can't delay constants..
-                        const auto lb = slv.arith_value(xpr) + (units_per_tick > at_atm->second ? units_per_tick : at_atm->second);
-                        auto [it, added] = adaptations.at(atm).bounds.emplace(&*xpr, nullptr);
-                        if (added)
-                        { // we have to add new bounds..
-                            const auto bnds = slv.arith_bounds(xpr);
-                            it->second = new atom_adaptation::arith_bounds(lb, bnds.second);
-                        }
-                        else // we update the lower bound..
-                            static_cast<atom_adaptation::arith_bounds &>(*it->second).lb = lb;
-                        if (xpr->get_type() == slv.get_real_type())
-                        { // we have a real variable..
-                            if (!slv.get_lra_theory().set_lb(slv.get_lra_theory().new_var(static_cast<ratio::arith_item &>(*xpr).get_lin()), lb, adaptations.at(atm).sigma_xi))
-                            { // setting the lower bound caused a conflict..
-                                swap_conflict(slv.get_lra_theory());
-                                if (!backtrack_analyze_and_backjump())
-                                    throw execution_exception();
-                            }
-                        }
-                        else
-                            throw std::runtime_error("not implemented yet");
-                        delays = true;
-                        dont_start.erase(at_atm);
+                        delays.push_back({atm, idx, true, *atoms[idx].start_delay});
+                        atoms[idx].start_delay.reset();
                     }
-            if (const auto ending_atms = e_atms.find(*pulses.cbegin()); ending_atms != e_atms.cend())
-                for (const auto &atm : ending_atms->second)
-                    if (const auto at_atm = dont_end.find(atm); at_atm != dont_end.end())
+                for (const auto &atm : pulses.back().ending)
+                    if (const auto idx = index_of(*atm); atoms[idx].end_delay)
                     { // this ending atom is not ready to be ended..
-                        auto &xpr = slv.is_impulse(*atm) ? atm->get(RATIO_AT) : atm->get(RATIO_END);
-                        if (slv.is_constant(xpr))
-                            throw execution_exception(); // we can't delay constants
-                        const auto lb = slv.arith_value(xpr) + (units_per_tick > at_atm->second ? units_per_tick : at_atm->second);
-                        auto [it, added] = adaptations.at(atm).bounds.emplace(&*xpr, nullptr);
-                        if (added)
-                        { // we have to add new bounds..
-                            const auto bnds = slv.arith_bounds(xpr);
-                            it->second = new atom_adaptation::arith_bounds(lb, bnds.second);
-                        }
-                        else // we update the lower bound..
-                            static_cast<atom_adaptation::arith_bounds &>(*it->second).lb = lb;
-                        if (xpr->get_type() == slv.get_real_type())
-                        { // we have a real variable..
-                            if (!slv.get_lra_theory().set_lb(slv.get_lra_theory().new_var(static_cast<ratio::arith_item &>(*xpr).get_lin()), lb, adaptations.at(atm).sigma_xi))
-                            { // setting the lower bound caused a conflict..
-                                swap_conflict(slv.get_lra_theory());
-                                if (!backtrack_analyze_and_backjump())
-                                    throw execution_exception();
-                            }
-                        }
-                        else
-                            throw std::runtime_error("not implemented yet");
-                        delays = true;
-                        dont_end.erase(at_atm);
+                        delays.push_back({atm, idx, false, *atoms[idx].end_delay});
+                        atoms[idx].end_delay.reset();
+                        --pending_end_delays;
                     }
 
-            if (delays)
-            { // we have some delays: we propagate and remove new possible flaws..
-                if (!slv.get_sat_core().propagate() || !slv.solve())
+                if (!delays.empty())
+                { // we have some delays: we store them all and enforce them within a single propagation..
+                    apply_delays(delays);
+                    if (!slv.get_sat_core().propagate())
+                        throw execution_exception();
+                }
+            }
+
+            if (!delays.empty())
+            { // we remove new possible flaws..
+                MEASURE_LATENCY(SolvePhase);
+                if (!slv.solve())
                     throw execution_exception();
                 goto manage_tick;
             }
 
-            if (const auto starting_atms = s_atms.find(*pulses.cbegin()); starting_atms != s_atms.cend())
-            { // we have to freeze the starting atoms..
-                for (auto &atm : starting_atms->second)
-                    for (const auto &[xpr_name, xpr] : atm->get_vars()) // we freeze the starting atoms' expressions..
-                        if (xpr_name != RATIO_AT && xpr_name != RATIO_DURATION && xpr_name != RATIO_END)
-                        { // we store the value for propagating it in case of backtracking..
-                            auto *itm = &*xpr;
-                            if (const auto bi = dynamic_cast<const ratio::bool_item *>(itm))
-                            { // we store the propositional value..
-                                assert(slv.get_sat_core().value(bi->get_lit()) != utils::Undefined);
-                                adaptations.at(atm).bounds.emplace(itm, new atom_adaptation::bool_bounds(slv.get_sat_core().value(bi->get_lit())));
-                            }
-                            else if (const auto ai = dynamic_cast<const ratio::arith_item *>(itm))
-                            { // we store the arithmetic value and, if not a constant, we propagate also the bounds..
-                                if (slv.is_constant(xpr))
-                                    continue; // we have a constant: nothing to propagate..
-                                if (&ai->get_type() == &slv.get_real_type())
-                                { // we have a real variable..
-                                    const auto val = slv.get_lra_theory().value(ai->get_lin());
-                                    adaptations.at(atm).bounds.emplace(itm, new atom_adaptation::arith_bounds(val, val));
-                                    // we freeze the arithmetic value..
-                                    if (!slv.get_lra_theory().set(slv.get_lra_theory().new_var(ai->get_lin()), val, adaptations.at(atm).sigma_xi))
-                                    { // freezing the arithmetic expression caused a conflict..
-                                        swap_conflict(slv.get_lra_theory());
-                                        if (!backtrack_analyze_and_backjump())
-                                            throw execution_exception();
-                                    }
-                                }
-                            }
-                            else if (const auto vi = dynamic_cast<const ratio::enum_item *>(itm))
-                            { // we store the variable value..
-                                const auto vals = slv.get_ov_theory().value(vi->get_var());
-                                assert(vals.size() == 1);
-                                adaptations.at(atm).bounds.emplace(itm, new atom_adaptation::var_bounds(**vals.begin()));
-                            }
-                        }
-                // we add the starting atoms to the set of atoms executing..
-                executing.insert(starting_atms->second.cbegin(), starting_atms->second.cend());
-                // we notify that some atoms are starting their execution..
-                for (const auto &l : listeners)
-                    l->start(starting_atms->second);
-            }
-            if (const auto ending_atms = e_atms.find(*pulses.cbegin()); ending_atms != e_atms.cend())
-            { // we freeze the `at` and the `end` of the ending atoms..
-                for (auto &atm : ending_atms->second)
-                    if (slv.is_impulse(*atm))
-                    { // we have an impulsive atom..
-                        auto &at = atm->get(RATIO_AT);
-                        if (slv.is_constant(at))
-                            continue; // we have a constant: nothing to propagate..
-                        const auto val = slv.arith_value(at);
-                        auto [it, added] = adaptations.at(atm).bounds.emplace(&*at, nullptr);
-                        if (added) // we have to add new bounds..
-                            it->second = new atom_adaptation::arith_bounds(val, val);
-                        else
-                        { // we update the bounds..
-                            static_cast<atom_adaptation::arith_bounds &>(*it->second).lb = val;
-                            static_cast<atom_adaptation::arith_bounds &>(*it->second).ub = val;
-                        }
-                        if (at->get_type() == slv.get_real_type())
-                        { // we have a real variable..
-                            if (!slv.get_lra_theory().set(slv.get_lra_theory().new_var(static_cast<ratio::arith_item &>(*at).get_lin()), val, adaptations.at(atm).sigma_xi))
-                            { // freezing the arithmetic expression caused a conflict..
-                                swap_conflict(slv.get_lra_theory());
-                                if (!backtrack_analyze_and_backjump())
-                                    throw execution_exception();
-                            }
-                        }
-                        else
-                            throw std::runtime_error("not implemented yet");
+            { // we freeze the starting atoms, as well as the `at` and the `end` of the ending atoms..
+                MEASURE_LATENCY(FreezePhase);
+                if (!pulses.back().starting.empty())
+                    freeze_starting(pulses.back().starting);
+                if (!pulses.back().ending.empty())
+                    freeze_ending(pulses.back().ending);
+            }
+
+            // the frozen atoms are no more indexed at this pulse: we consume it before the listeners can change the timelines..
+            const auto c_pulse = pulses.take_back();
+            {
+                MEASURE_LATENCY(DispatchPhase);
+                if (!c_pulse.starting.empty())
+                    // we notify that some atoms are starting their execution..
+                    for (const auto &l : listeners)
+                        l->start(c_pulse.starting);
+                if (!c_pulse.ending.empty())
+                    // we notify that some atoms are ending their execution..
+                    for (const auto &l : listeners)
+                        l->end(c_pulse.ending);
+            }
+        }
+        if (pending_requirements)
+            goto manage_tick; // the listeners have adapted the plan..
+
+#ifdef MULTIPLE_EXECUTORS
+        // while replanning, the listeners cannot read the solver: the end of the execution is notified once the new plan is swapped in..
+        if (!replanning && slv.arith_value(slv.get("horizon")) <= current_time && !pending_end_delays)
+#else
+        if (slv.arith_value(slv.get("horizon")) <= current_time && !pending_end_delays)
+#endif
+        { // we have reached the horizon..
+            MEASURE_LATENCY(DispatchPhase);
+            state = executor_state::Finished;
+            // we notify that the execution has finished..
+            for (const auto &l : listeners)
+                l->executor_state_changed(state);
+        }
+
+        // we update the current time..
+        current_time += units_per_tick;
+
+        { // we notify that a tick has arised..
+            MEASURE_LATENCY(DispatchPhase);
+            for (const auto &l : listeners)
+                l->tick(current_time);
+        }
+
+#ifdef MULTIPLE_EXECUTORS
+        if (replanning)
+            return; // the checkpoint is postponed until the new plan is swapped in..
+#endif
+        if (checkpoint_every && ++ticks_since_checkpoint >= checkpoint_every)
+        { // we write a periodic checkpoint..
+            ticks_since_checkpoint = 0;
+            write_checkpoint(checkpoint_path);
+        }
+    }
+
+    void executor::freeze_starting(const std::unordered_set<ratio::atom *> &atms)
+    {
+        for (auto &atm : atms)
+        {
+            auto &adapt = adaptations[index_of(*atm)];
+            for (const auto &[xpr_name, xpr] : atm->get_vars()) // we freeze the starting atoms' expressions..
+                if (xpr_name != RATIO_AT && xpr_name != RATIO_DURATION && xpr_name != RATIO_END)
+                { // we store the value for propagating it in case of backtracking..
+                    auto *itm = &*xpr;
+                    if (const auto bi = dynamic_cast<const ratio::bool_item *>(itm))
+                    { // we store the propositional value..
+                        assert(slv.get_sat_core().value(bi->get_lit()) != utils::Undefined);
+                        if (!adapt.get_bounds(*bi))
+                            adapt.bool_bnds.emplace_back(*bi, slv.get_sat_core().value(bi->get_lit()));
                     }
-                    else if (slv.is_interval(*atm))
-                    { // we have an interval atom..
-                        auto &end = atm->get(RATIO_END);
-                        if (slv.is_constant(end))
+                    else if (const auto ai = dynamic_cast<const ratio::arith_item *>(itm))
+                    { // we store the arithmetic value and, if not a constant, we propagate also the bounds..
+                        if (slv.is_constant(xpr))
                             continue; // we have a constant: nothing to propagate..
-                        const auto val = slv.arith_value(end);
-                        auto [it, added] = adaptations.at(atm).bounds.emplace(&*end, nullptr);
-                        if (added) // we have to add new bounds..
-                            it->second = new atom_adaptation::arith_bounds(val, val);
-                        else
-                        { // we update the bounds..
-                            static_cast<atom_adaptation::arith_bounds &>(*it->second).lb = val;
-                            static_cast<atom_adaptation::arith_bounds &>(*it->second).ub = val;
-                        }
-                        if (end->get_type() == slv.get_real_type())
+                        if (&ai->get_type() == &slv.get_real_type())
                         { // we have a real variable..
-                            if (!slv.get_lra_theory().set(slv.get_lra_theory().new_var(static_cast<ratio::arith_item &>(*end).get_lin()), val, adaptations.at(atm).sigma_xi))
+                            const auto val = slv.get_lra_theory().value(ai->get_lin());
+                            if (!adapt.get_bounds(*ai))
+                                adapt.arith_bnds.emplace_back(*ai, val, val);
+                            // we freeze the arithmetic value..
+                            if (!slv.get_lra_theory().set(slv.get_lra_theory().new_var(ai->get_lin()), val, adapt.sigma_xi))
                             { // freezing the arithmetic expression caused a conflict..
                                 swap_conflict(slv.get_lra_theory());
                                 if (!backtrack_analyze_and_backjump())
                                     throw execution_exception();
                             }
                         }
-                        else
-                            throw std::runtime_error("not implemented yet");
                     }
-                // we remove the ending atoms from the set of atoms executing..
-                for (const auto &atm : ending_atms->second)
-                    executing.erase(atm);
-                // we notify that some atoms are ending their execution..
-                for (const auto &l : listeners)
-                    l->end(ending_atms->second);
+                    else if (const auto vi = dynamic_cast<const ratio::enum_item *>(itm))
+                    { // we store the variable value..
+                        const auto vals = slv.get_ov_theory().value(vi->get_var());
+                        assert(vals.size() == 1);
+                        if (!adapt.get_bounds(*vi))
+                            adapt.var_bnds.emplace_back(*vi, **vals.begin());
+                    }
+                }
+        }
+        // we add the starting atoms to the atoms executing..
+        for (const auto &atm : atms)
+        {
+            const auto idx = index_of(*atm);
+            set_executing(idx);
+            set_dirty(idx);
+            if (atoms[idx].pulses) // the starting atoms are no more indexed at their start pulse..
+                atoms[idx].pulses->start.reset();
+        }
+    }
+
+    void executor::freeze_ending(const std::unordered_set<ratio::atom *> &atms)
+    {
+        for (auto &atm : atms)
+            if (slv.is_impulse(*atm))
+            { // we have an impulsive atom..
+                auto &at = atm->get(RATIO_AT);
+                if (slv.is_constant(at))
+                    continue; // we have a constant: nothing to propagate..
+                const auto val = slv.arith_value(at);
+                auto &adapt = adaptations[index_of(*atm)];
+                if (auto bnds = adapt.get_bounds(static_cast<ratio::arith_item &>(*at)))
+                { // we update the bounds..
+                    bnds->lb = val;
+                    bnds->ub = val;
+                }
+                else // we have to add new bounds..
+                    adapt.arith_bnds.emplace_back(static_cast<ratio::arith_item &>(*at), val, val);
+                if (at->get_type() == slv.get_real_type())
+                { // we have a real variable..
+                    if (!slv.get_lra_theory().set(slv.get_lra_theory().new_var(static_cast<ratio::arith_item &>(*at).get_lin()), val, adapt.sigma_xi))
+                    { // freezing the arithmetic expression caused a conflict..
+                        swap_conflict(slv.get_lra_theory());
+                        if (!backtrack_analyze_and_backjump())
+                            throw execution_exception();
+                    }
+                }
+                else
+                    throw std::runtime_error("not implemented yet");
+            }
+            else if (slv.is_interval(*atm))
+            { // we have an interval atom..
+                auto &end = atm->get(RATIO_END);
+                if (slv.is_constant(end))
+                    continue; // we have a constant: nothing to propagate..
+                const auto val = slv.arith_value(end);
+                auto &adapt = adaptations[index_of(*atm)];
+                if (auto bnds = adapt.get_bounds(static_cast<ratio::arith_item &>(*end)))
+                { // we update the bounds..
+                    bnds->lb = val;
+                    bnds->ub = val;
+                }
+                else // we have to add new bounds..
+                    adapt.arith_bnds.emplace_back(static_cast<ratio::arith_item &>(*end), val, val);
+                if (end->get_type() == slv.get_real_type())
+                { // we have a real variable..
+                    if (!slv.get_lra_theory().set(slv.get_lra_theory().new_var(static_cast<ratio::arith_item &>(*end).get_lin()), val, adapt.sigma_xi))
+                    { // freezing the arithmetic expression caused a conflict..
+                        swap_conflict(slv.get_lra_theory());
+                        if (!backtrack_analyze_and_backjump())
+                            throw execution_exception();
+                    }
+                }
+                else
+                    throw std::runtime_error("not implemented yet");
             }
+        // we remove the ending atoms from the atoms executing..
+        for (const auto &atm : atms)
+        {
+            const auto idx = index_of(*atm);
+            set_dirty(idx);
+            ended_atoms.push_back(idx);
+            unset_executing(idx);
+            atoms[idx].pulses.reset(); // the ending atoms do not need to be tracked anymore..
+        }
+    }
 
-            pulses.erase(pulses.cbegin());
+    PLEXA_EXPORT void executor::tick(const size_t &ticks)
+    {
+        size_t remaining = ticks;
+        while (remaining)
+        {
+            { // we jump over the idle ticks..
+#ifdef MULTIPLE_EXECUTORS
+                const std::lock_guard<std::mutex> lock(mtx);
+#endif
+                if (const auto idle = std::min(remaining - 1, idle_ticks()))
+                {
+                    current_time += units_per_tick * utils::rational(static_cast<long long>(idle));
+                    remaining -= idle;
+                }
+            }
+            tick();
+            --remaining;
         }
+    }
 
-        if (slv.arith_value(slv.get("horizon")) <= current_time && dont_end.empty())
-        { // we have reached the horizon..
-            state = executor_state::Finished;
-            // we notify that the execution has finished..
-            for (const auto &l : listeners)
-                l->executor_state_changed(state);
+    PLEXA_EXPORT utils::inf_rational executor::get_next_pulse()
+    {
+#ifdef MULTIPLE_EXECUTORS
+        const std::lock_guard<std::mutex> lock(mtx);
+#endif
+        return next_pulse();
+    }
+
+    PLEXA_EXPORT size_t executor::get_idle_ticks()
+    {
+#ifdef MULTIPLE_EXECUTORS
+        const std::lock_guard<std::mutex> lock(mtx);
+#endif
+        return idle_ticks();
+    }
+
+    utils::inf_rational executor::next_pulse()
+    {
+        utils::inf_rational next(utils::rational::POSITIVE_INFINITY);
+        if (!pulses.empty())
+            next = pulses.back().time;
+        if (state != executor_state::Finished)
+        {
+#ifdef MULTIPLE_EXECUTORS
+            const auto horizon = replanning ? planned_horizon : slv.arith_value(slv.get("horizon"));
+#else
+            const auto horizon = slv.arith_value(slv.get("horizon"));
+#endif
+            if (horizon < next)
+                next = horizon;
         }
+        return next;
+    }
 
-        // we update the current time..
-        current_time += units_per_tick;
+    size_t executor::idle_ticks()
+    {
+        if (!running || pending_requirements)
+            return 0;
+#ifdef MULTIPLE_EXECUTORS
+        if (replanning)
+            return 0; // the new plan is checked for at each tick..
+#endif
+        const auto next = next_pulse();
+        if (next == utils::inf_rational(utils::rational::POSITIVE_INFINITY))
+            return std::numeric_limits<size_t>::max();
+        if (next <= current_time)
+            return 0;
+        // the ticks at `current_time + i * units_per_tick` are idle as long as they precede the next pulse..
+        const auto ticks = (next.get_rational() - current_time) / units_per_tick;
+        if (next.get_infinitesimal() > utils::rational::ZERO)
+            return static_cast<size_t>(ticks.numerator() / ticks.denominator() + 1);
+        return static_cast<size_t>((ticks.numerator() + ticks.denominator() - 1) / ticks.denominator());
+    }
+
+    PLEXA_EXPORT void executor::adapt(const std::string &script)
+    {
+#ifdef MULTIPLE_EXECUTORS
+        commands.push([this, script]()
+                      { read_script(script); });
+#else
+        read_script(script);
+#endif
+    }
+    PLEXA_EXPORT void executor::adapt(const std::vector<std::string> &files)
+    {
+#ifdef MULTIPLE_EXECUTORS
+        commands.push([this, files]()
+                      { read_files(files); });
+#else
+        read_files(files);
+#endif
+    }
 
-        // we notify that a tick has arised..
+    PLEXA_EXPORT void executor::dont_start_yet(const std::unordered_map<const ratio::atom *, utils::rational> &atoms)
+    {
+#ifdef MULTIPLE_EXECUTORS
+        delay_requests.push([this, atoms]()
+                      {
+                          for (const auto &[atm, delay] : atoms)
+                              if (const auto idx = index_of(*atm); idx != npos && !this->atoms[idx].start_delay)
+                                  this->atoms[idx].start_delay = delay;
+                          for (const auto &l : listeners)
+                              l->start_delayed(atoms); });
+#else
+        for (const auto &[atm, delay] : atoms)
+            if (const auto idx = index_of(*atm); idx != npos && !this->atoms[idx].start_delay)
+                this->atoms[idx].start_delay = delay;
         for (const auto &l : listeners)
-            l->tick(current_time);
+            l->start_delayed(atoms);
+#endif
+    }
+    PLEXA_EXPORT void executor::dont_end_yet(const std::unordered_map<const ratio::atom *, utils::rational> &atoms)
+    {
+#ifdef MULTIPLE_EXECUTORS
+        delay_requests.push([this, atoms]()
+                      {
+                          for (const auto &[atm, delay] : atoms)
+                              if (const auto idx = index_of(*atm); idx != npos && !this->atoms[idx].end_delay)
+                              {
+                                  this->atoms[idx].end_delay = delay;
+                                  ++pending_end_delays;
+                              }
+                          for (const auto &l : listeners)
+                              l->end_delayed(atoms); });
+#else
+        for (const auto &[atm, delay] : atoms)
+            if (const auto idx = index_of(*atm); idx != npos && !this->atoms[idx].end_delay)
+            {
+                this->atoms[idx].end_delay = delay;
+                ++pending_end_delays;
+            }
+        for (const auto &l : listeners)
+            l->end_delayed(atoms);
+#endif
     }
 
-    PLEXA_EXPORT void executor::adapt(const std::string &script)
+    PLEXA_EXPORT void executor::failure(const std::unordered_set<const ratio::atom *> &atoms)
+    {
+#ifdef MULTIPLE_EXECUTORS
+        commands.push([this, atoms]()
+                      { fail(atoms); });
+#else
+        fail(atoms);
+#endif
+    }
+
+    PLEXA_EXPORT executor::snapshot executor::take_snapshot()
+    {
+#ifdef MULTIPLE_EXECUTORS
+        const std::lock_guard<std::mutex> lock(mtx);
+        if (replanning) // the snapshot must include the atoms dispatched while replanning..
+            finish_replanning();
+#endif
+        // we copy only the adaptations which have changed since the last snapshot, the other ones being shared..
+        snapshot_adaptations.resize(atoms.size());
+        for (const auto &idx : dirty_adaptations)
+        {
+            snapshot_adaptations[idx] = std::make_shared<const atom_adaptation>(adaptations[idx]);
+            atoms[idx].dirty = false;
+        }
+        dirty_adaptations.clear();
+
+        snapshot snp;
+        snp.current_time = current_time;
+        snp.compactions = compactions;
+        // the containers are shared, copy-on-write, with the snapshot..
+        snp.atoms = atoms;
+        snp.executing = executing;
+        snp.ended_atoms = ended_atoms;
+        snp.adaptations = snapshot_adaptations;
+        snp.pulses = pulses;
+        return snp;
+    }
+
+    PLEXA_EXPORT void executor::restore(const snapshot &snp)
+    {
+#ifdef MULTIPLE_EXECUTORS
+        commands.push([this, snp]()
+                      { restore_snapshot(snp); });
+#else
+        restore_snapshot(snp);
+#endif
+    }
+
+    PLEXA_EXPORT void executor::set_checkpointing(const std::string &path, const size_t &every)
+    {
+#ifdef MULTIPLE_EXECUTORS
+        const std::lock_guard<std::mutex> lock(mtx);
+#endif
+        checkpoint_path = path;
+        checkpoint_every = every;
+        ticks_since_checkpoint = 0;
+    }
+
+    PLEXA_EXPORT void executor::save_checkpoint(const std::string &path)
+    {
+#ifdef MULTIPLE_EXECUTORS
+        const std::lock_guard<std::mutex> lock(mtx);
+        if (replanning) // the checkpoint must include the atoms dispatched while replanning..
+            finish_replanning();
+#endif
+        write_checkpoint(path);
+    }
+
+    PLEXA_EXPORT void executor::load_checkpoint(const std::string &path)
     {
+        std::ifstream in(path, std::ios::binary);
+        char magic[4];
+        if (!in || !in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), checkpoint_magic) || read_uint(in, 4) != checkpoint_version)
+            throw std::invalid_argument("invalid checkpoint file " + path);
+
+        const auto time = read_rational(in);
+        std::unordered_map<semitone::var, checkpointed_atom> c_atoms;
+        for (auto n = read_uint(in, 4); n; --n)
+        {
+            auto &c_atm = c_atoms[static_cast<semitone::var>(read_uint(in, 8))];
+            const auto flags = read_uint(in, 1);
+            c_atm.executing = flags & 1;
+            if (flags & 2)
+                c_atm.start_delay = read_rational(in);
+            if (flags & 4)
+                c_atm.end_delay = read_rational(in);
+            for (auto n_bool = read_uint(in, 4); n_bool; --n_bool)
+            {
+                auto name = read_string(in);
+                c_atm.bool_bnds.emplace_back(std::move(name), static_cast<utils::lbool>(read_uint(in, 1)));
+            }
+            for (auto n_arith = read_uint(in, 4); n_arith; --n_arith)
+            {
+                auto name = read_string(in);
+                auto lb = read_inf_rational(in);
+                auto ub = read_inf_rational(in);
+                c_atm.arith_bnds.emplace_back(std::move(name), std::make_pair(lb, ub));
+            }
+        }
+
 #ifdef MULTIPLE_EXECUTORS
         const std::lock_guard<std::mutex> lock(mtx);
+#endif
+        current_time = time;
+        checkpointed_atoms = std::move(c_atoms);
+    }
+
+#ifdef LATENCY_HISTOGRAMS
+    PLEXA_EXPORT void executor::reset_latencies() noexcept
+    {
+        for (auto &hist : latencies)
+            hist.reset();
+    }
+
+    PLEXA_EXPORT void executor::dump_latencies(std::ostream &os) const
+    {
+        for (size_t phase = 0; phase < PhaseCount; ++phase)
+            if (const auto &hist = latencies[phase]; hist.get_count())
+            {
+                os << "# " << to_string(static_cast<latency_phase>(phase)) << " count=" << hist.get_count() << " min=" << hist.get_min() << " mean=" << static_cast<uint64_t>(hist.get_mean()) << " p50=" << hist.get_percentile(0.5) << " p90=" << hist.get_percentile(0.9) << " p99=" << hist.get_percentile(0.99) << " p99.9=" << hist.get_percentile(0.999) << " max=" << hist.get_max() << '\n';
+                hist.dump(os);
+            }
+    }
+#endif
+
+    void executor::write_checkpoint(const std::string &path)
+    {
+        const auto tmp_path = path + ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out)
+                throw std::runtime_error("cannot write the checkpoint file " + path);
+            out.write(checkpoint_magic, sizeof(checkpoint_magic));
+            write_uint(out, checkpoint_version, 4);
+            write_rational(out, current_time);
+
+            write_uint(out, atoms.size() - free_indices.size() + checkpointed_atoms.size() + n_retired_atoms, 4);
+            for (const auto &c_atm : atoms)
+                if (c_atm.atm)
+                    write_checkpointed(out, variable(c_atm.atm->get_sigma()), to_checkpointed(index_of(*c_atm.atm)));
+            // we keep the loaded atoms which have not been created yet, as well as the retired ones..
+            for (const auto &[sigma, c_atm] : checkpointed_atoms)
+                write_checkpointed(out, sigma, c_atm);
+            if (retired_atoms)
+            { // we copy the records of the retired atoms from their file..
+                auto f = retired_atoms.get();
+                std::rewind(f);
+                char buffer[4096];
+                while (const auto n = std::fread(buffer, 1, sizeof(buffer), f))
+                    out.write(buffer, static_cast<std::streamsize>(n));
+                const bool failed = std::ferror(f);
+                std::fseek(f, 0, SEEK_END); // the next records are appended..
+                if (failed)
+                    throw std::runtime_error("cannot read the retired atoms for the checkpoint file " + path);
+            }
+            if (!out.flush())
+                throw std::runtime_error("cannot write the checkpoint file " + path);
+        }
+        // we replace the previous checkpoint only once the new one is complete..
+        std::filesystem::rename(tmp_path, path);
+    }
+
+    executor::checkpointed_atom executor::to_checkpointed(const size_t &idx) const
+    {
+        const auto &atm = *atoms[idx].atm;
+        const auto &adapt = adaptations[idx];
+        checkpointed_atom c_atm;
+        c_atm.executing = atoms[idx].executing != npos;
+        c_atm.start_delay = atoms[idx].start_delay;
+        c_atm.end_delay = atoms[idx].end_delay;
+        // we identify the bounded items by the name of the atom's parameters..
+        for (const auto &[xpr_name, xpr] : atm.get_vars())
+        {
+            const auto *itm = &*xpr;
+            for (const auto &bnds : adapt.bool_bnds)
+                if (bnds.itm == itm)
+                    c_atm.bool_bnds.emplace_back(xpr_name, bnds.val);
+            for (const auto &bnds : adapt.arith_bnds)
+                if (bnds.itm == itm)
+                    c_atm.arith_bnds.emplace_back(xpr_name, std::make_pair(bnds.lb, bnds.ub));
+        }
+        return c_atm;
+    }
+
+    void executor::write_checkpointed(std::ostream &os, const semitone::var &sigma, const checkpointed_atom &c_atm) const
+    {
+        write_uint(os, static_cast<uint64_t>(sigma), 8);
+        write_uint(os, (c_atm.executing ? 1 : 0) | (c_atm.start_delay ? 2 : 0) | (c_atm.end_delay ? 4 : 0), 1);
+        if (c_atm.start_delay)
+            write_rational(os, *c_atm.start_delay);
+        if (c_atm.end_delay)
+            write_rational(os, *c_atm.end_delay);
+        write_uint(os, c_atm.bool_bnds.size(), 4);
+        for (const auto &[xpr_name, val] : c_atm.bool_bnds)
+        {
+            write_string(os, xpr_name);
+            write_uint(os, static_cast<uint64_t>(val), 1);
+        }
+        write_uint(os, c_atm.arith_bnds.size(), 4);
+        for (const auto &[xpr_name, bnds] : c_atm.arith_bnds)
+        {
+            write_string(os, xpr_name);
+            write_inf_rational(os, bnds.first);
+            write_inf_rational(os, bnds.second);
+        }
+    }
+
+    void executor::restore_checkpointed(const size_t &idx)
+    {
+        auto &atm = *atoms[idx].atm;
+        auto &adapt = adaptations[idx];
+        const auto c_atm = checkpointed_atoms.find(variable(atm.get_sigma()));
+        if (c_atm == checkpointed_atoms.cend())
+            return;
+        for (const auto &[xpr_name, val] : c_atm->second.bool_bnds)
+            if (const auto bi = dynamic_cast<const ratio::bool_item *>(&*atm.get(xpr_name)))
+            {
+                if (auto bnds = adapt.get_bounds(*bi))
+                    bnds->val = val;
+                else
+                    adapt.bool_bnds.emplace_back(*bi, val);
+            }
+        for (const auto &[xpr_name, bnds] : c_atm->second.arith_bnds)
+            if (const auto ai = dynamic_cast<const ratio::arith_item *>(&*atm.get(xpr_name)))
+            {
+                if (auto c_bnds = adapt.get_bounds(*ai))
+                {
+                    c_bnds->lb = bnds.first;
+                    c_bnds->ub = bnds.second;
+                }
+                else
+                    adapt.arith_bnds.emplace_back(*ai, bnds.first, bnds.second);
+            }
+        if (c_atm->second.executing)
+            set_executing(idx);
+        atoms[idx].start_delay = c_atm->second.start_delay;
+        if (c_atm->second.end_delay)
+        {
+            atoms[idx].end_delay = c_atm->second.end_delay;
+            ++pending_end_delays;
+        }
+        checkpointed_atoms.erase(c_atm);
+    }
+
+    PLEXA_EXPORT void executor::compact()
+    {
+#ifdef MULTIPLE_EXECUTORS
+        commands.push([this]()
+                      { retire_ended_atoms(); });
+#else
+        retire_ended_atoms();
+#endif
+    }
+
+    void executor::retire_ended_atoms()
+    {
+        if (ended_atoms.empty())
+            return;
+#ifdef MULTIPLE_EXECUTORS
+        plan_captured = false; // the compacted plan is solved within the tick..
+#endif
+
+        { // the retired atoms are still needed for warm restarting the execution: we stream their records out of memory..
+            std::ostringstream records;
+            for (const auto &idx : ended_atoms)
+                write_checkpointed(records, variable(atoms[idx].atm->get_sigma()), to_checkpointed(idx));
+            const auto c_records = records.str();
+            if (!retired_atoms)
+                retired_atoms.reset(std::tmpfile());
+            if (!retired_atoms || std::fwrite(c_records.data(), 1, c_records.size(), retired_atoms.get()) != c_records.size())
+                throw std::runtime_error("cannot store the retired atoms..");
+            n_retired_atoms += ended_atoms.size();
+        }
+
+        while (!slv.get_sat_core().root_level()) // we go at root level..
+            slv.get_sat_core().pop();
+
+        // the ended atoms stay active and their bounds are enforced, at root level, by the propagation of their sigma_xi variables..
+        std::vector<bool> retired(atoms.size(), false);
+        for (const auto &idx : ended_atoms)
+        {
+            if (!slv.get_sat_core().new_clause({atoms[idx].atm->get_sigma()}) || !slv.get_sat_core().new_clause({adaptations[idx].sigma_xi}))
+                throw execution_exception();
+            retired[idx] = true;
+        }
+        if (!slv.get_sat_core().propagate())
+            throw execution_exception();
+
+        // the root-level bounds are never retracted, hence they need not to be propagated again..
+        active_adaptations.erase(std::remove_if(active_adaptations.begin(), active_adaptations.end(), [&retired](const size_t &idx)
+                                                { return retired[idx]; }),
+                                 active_adaptations.end());
+        dirty_adaptations.erase(std::remove_if(dirty_adaptations.begin(), dirty_adaptations.end(), [&retired](const size_t &idx)
+                                               { return retired[idx]; }),
+                                dirty_adaptations.end());
+        moved_atoms.erase(std::remove_if(moved_atoms.begin(), moved_atoms.end(), [&retired](const size_t &idx)
+                                         { return retired[idx]; }),
+                          moved_atoms.end());
+        assigned_sigmas.erase(std::remove_if(assigned_sigmas.begin(), assigned_sigmas.end(), [&retired](const size_t &idx)
+                                             { return retired[idx]; }),
+                              assigned_sigmas.end());
+        for (const auto &idx : ended_atoms)
+        {
+            for (const auto &x : get_time_vars(*atoms[idx].atm))
+            { // the frozen times of the retired atom do not move anymore..
+                auto &atms = time_vars[x];
+                atms.erase(std::remove(atms.begin(), atms.end(), idx), atms.end());
+                if (atms.empty())
+                    time_vars.erase(x);
+            }
+            if (atoms[idx].end_delay)
+                --pending_end_delays;
+            var_index[variable(atoms[idx].atm->get_sigma())] = npos;
+            var_index[variable(adaptations[idx].sigma_xi)] = npos;
+            // we release the bounds of the atom, making its index available for reuse..
+            atoms[idx] = indexed_atom();
+            adaptations[idx] = atom_adaptation(adaptations[idx].sigma_xi, arena);
+            free_indices.push_back(idx);
+        }
+        ended_atoms.clear();
+
+        // the previous snapshots refer to the retired atoms..
+        for (size_t idx = 0; idx < snapshot_adaptations.size(); ++idx)
+            if (retired[idx])
+                snapshot_adaptations[idx].reset();
+        ++compactions;
+
+        pending_requirements = true;
+    }
+
+    void executor::solve_pending_requirements()
+    {
+        if (warm_start && !warm_decisions.empty())
+            try
+            { // we replay the decisions of the previous solution which are still undecided..
+                for (const auto &d : warm_decisions)
+                    if (slv.get_sat_core().value(d) == utils::Undefined)
+                        slv.take_decision(d);
+            }
+            catch (...)
+            { // the previous solution leads nowhere: we solve the problem from scratch..
+                warm_decisions.clear();
+                while (!slv.get_sat_core().root_level())
+                    slv.get_sat_core().pop();
+            }
+        slv.solve();
+    }
+
+#ifdef MULTIPLE_EXECUTORS
+    void executor::capture_plan()
+    {
+        // the values of the current plan are captured before the solver goes back to the root level..
+        planned_starts.clear();
+        planned_ends.clear();
+        for (const auto &c_pulse : pulses)
+        {
+            for (const auto &atm : c_pulse.starting)
+                planned_starts.emplace(atm, get_planned_values(*atm, true));
+            for (const auto &atm : c_pulse.ending)
+                planned_ends.emplace(atm, get_planned_values(*atm, false));
+        }
+        planned_horizon = slv.arith_value(slv.get("horizon"));
+        plan_captured = true;
+    }
+
+    executor::planned_values executor::get_planned_values(const ratio::atom &atm, const bool &starting) const
+    {
+        planned_values vals;
+        if (starting)
+        { // we collect the values frozen by `freeze_starting`..
+            for (const auto &[xpr_name, xpr] : atm.get_vars())
+                if (xpr_name != RATIO_AT && xpr_name != RATIO_DURATION && xpr_name != RATIO_END)
+                {
+                    const auto *itm = &*xpr;
+                    if (const auto bi = dynamic_cast<const ratio::bool_item *>(itm))
+                        vals.bools.emplace_back(bi, slv.get_sat_core().value(bi->get_lit()));
+                    else if (const auto ai = dynamic_cast<const ratio::arith_item *>(itm))
+                    {
+                        if (!slv.is_constant(xpr) && &ai->get_type() == &slv.get_real_type())
+                            vals.ariths.emplace_back(ai, slv.get_lra_theory().value(ai->get_lin()));
+                    }
+                    else if (const auto vi = dynamic_cast<const ratio::enum_item *>(itm))
+                        vals.vars.emplace_back(vi, *slv.get_ov_theory().value(vi->get_var()).begin());
+                }
+        }
+        else
+        { // we collect the value frozen by `freeze_ending`..
+            const auto &xpr = atm.get(slv.is_impulse(atm) ? RATIO_AT : RATIO_END);
+            if (!slv.is_constant(xpr) && xpr->get_type() == slv.get_real_type())
+            {
+                const auto ai = static_cast<const ratio::arith_item *>(&*xpr);
+                vals.ariths.emplace_back(ai, slv.get_lra_theory().value(ai->get_lin()));
+            }
+        }
+        return vals;
+    }
+
+    bool executor::agrees(const planned_values &vals) const
+    {
+        for (const auto &[bi, val] : vals.bools)
+            if (slv.get_sat_core().value(bi->get_lit()) != val)
+                return false;
+        for (const auto &[ai, val] : vals.ariths)
+            if (slv.get_lra_theory().value(ai->get_lin()) != val)
+                return false;
+        for (const auto &[vi, val] : vals.vars)
+            if (const auto c_vals = slv.get_ov_theory().value(vi->get_var()); c_vals.size() != 1 || *c_vals.begin() != val)
+                return false;
+        return true;
+    }
+
+    void executor::enforce(const size_t &idx, const planned_values &vals)
+    {
+        auto &adapt = adaptations[idx];
+        for (const auto &[bi, val] : vals.bools)
+            if (auto bnds = adapt.get_bounds(*bi))
+                bnds->val = val;
+            else
+                adapt.bool_bnds.emplace_back(*bi, val);
+        for (const auto &[ai, val] : vals.ariths)
+            if (auto bnds = adapt.get_bounds(*ai))
+            {
+                bnds->lb = val;
+                bnds->ub = val;
+            }
+            else
+                adapt.arith_bnds.emplace_back(*ai, val, val);
+        for (const auto &[vi, val] : vals.vars)
+            if (auto bnds = adapt.get_bounds(*vi))
+                bnds->val = val;
+            else
+                adapt.var_bnds.emplace_back(*vi, *val);
+        set_dirty(idx);
+    }
+
+    void executor::start_replanning()
+    {
+        plan_captured = false;
+        if (!checkpointed_atoms.empty() || std::any_of(atoms.cbegin(), atoms.cend(), [](const indexed_atom &c_atm)
+                                                       { return c_atm.start_delay || c_atm.end_delay; }))
+            return; // the delays and the loaded checkpoint are applied by the executing thread: we solve the problem within the tick..
+
+        pending_requirements = false;
+        replanning = true;
+        replanning_failed = false;
+        replanned = false;
+        planned_time = current_time;
+
+        state = executor_state::Adapting;
+        for (const auto &l : listeners)
+            l->executor_state_changed(state);
+
+        // the solver cannot be copied: the background thread takes it over, while the executing thread dispatches the captured plan..
+        replanner = std::thread([this]()
+                                {
+                                    try
+                                    {
+                                        solve_pending_requirements();
+                                    }
+                                    catch (...)
+                                    {
+                                        replanning_exception = std::current_exception();
+                                    }
+                                    replanned.store(true, std::memory_order_release); });
+    }
+
+    void executor::finish_replanning()
+    {
+        replanner.join();
+        const auto stop_replanning = [this]()
+        {
+            replanning = false;
+            dispatched.clear();
+            planned_starts.clear();
+            planned_ends.clear();
+        };
+        if (replanning_exception)
+        { // the new plan cannot be executed..
+            stop_replanning();
+            std::rethrow_exception(std::exchange(replanning_exception, nullptr));
+        }
+        if (replanning_failed)
+        { // the new requirements are inconsistent..
+            stop_replanning();
+            inconsistent_problem();
+            return;
+        }
+
+        // we check that the new plan agrees with the atoms dispatched in the meanwhile, and that it does not start the other atoms in the past..
+        bool consistent = true;
+        std::unordered_set<const ratio::atom *> started;
+        for (const auto &[starting, atms] : dispatched)
+            for (const auto &atm : atms)
+                if (starting)
+                {
+                    started.insert(atm);
+                    consistent &= agrees(planned_starts.at(atm));
+                }
+                else
+                    consistent &= agrees(planned_ends.at(atm));
+        std::vector<size_t> late;
+        for (size_t idx = 0; idx < atoms.size(); ++idx)
+            if (const auto &c_atm = std::as_const(atoms)[idx]; c_atm.pulses && c_atm.executing == npos && !started.count(c_atm.atm) && slv.get_sat_core().value(c_atm.atm->get_sigma()) == utils::True)
+                if (slv.arith_value(c_atm.atm->get(slv.is_impulse(*c_atm.atm) ? RATIO_AT : RATIO_START)) < current_time)
+                    late.push_back(idx);
+
+        if (!consistent || !late.empty())
+        { // we enforce the dispatched values, as well as the start of the late atoms, and we solve the problem again..
+            MEASURE_LATENCY(SolvePhase);
+            PLEXA_LOG_DEBUG("the new plan disagrees with the dispatched one: solving again..");
+            for (const auto &[starting, atms] : dispatched)
+                for (const auto &atm : atms)
+                    enforce(index_of(*atm), starting ? planned_starts.at(atm) : planned_ends.at(atm));
+            for (const auto &idx : late)
+            {
+                auto &xpr = atoms[idx].atm->get(slv.is_impulse(*atoms[idx].atm) ? RATIO_AT : RATIO_START);
+                auto &adapt = adaptations[idx];
+                if (auto bnds = adapt.get_bounds(static_cast<ratio::arith_item &>(*xpr)))
+                { // we update the lower bound..
+                    if (bnds->lb < current_time)
+                        bnds->lb = current_time;
+                }
+                else // we have to add new bounds..
+                    adapt.arith_bnds.emplace_back(static_cast<ratio::arith_item &>(*xpr), utils::inf_rational(current_time), slv.arith_bounds(xpr).second);
+                set_dirty(idx);
+            }
+            while (!slv.get_sat_core().root_level()) // we go at root level..
+                slv.get_sat_core().pop();
+            planned_time = current_time;
+            try
+            {
+                slv.solve();
+            }
+            catch (...)
+            {
+                stop_replanning();
+                throw;
+            }
+            if (replanning_failed)
+            { // the dispatched plan cannot be continued..
+                stop_replanning();
+                inconsistent_problem();
+                return;
+            }
+        }
+
+        // we freeze the dispatched atoms, in the order they have been dispatched, and we swap in the new timelines..
+        const auto c_dispatched = std::move(dispatched);
+        stop_replanning();
+        for (const auto &[starting, atms] : c_dispatched)
+            if (starting)
+                freeze_starting(atms);
+            else
+                freeze_ending(atms);
+        build_timelines();
+
+        state = running ? executor_state::Executing : executor_state::Idle;
+        for (const auto &l : listeners)
+            l->executor_state_changed(state);
+    }
+#endif
+
+    void executor::read_script(const std::string &script)
+    {
+        MEASURE_LATENCY(AdaptPhase);
+        for (const auto &l : listeners)
+            l->adapting(script);
+#ifdef MULTIPLE_EXECUTORS
+        if (background_replanning && running && !pending_requirements)
+            capture_plan();
 #endif
         while (!slv.get_sat_core().root_level()) // we go at root level..
             slv.get_sat_core().pop();
         slv.read(script);
         pending_requirements = true;
     }
-    PLEXA_EXPORT void executor::adapt(const std::vector<std::string> &files)
+    void executor::read_files(const std::vector<std::string> &files)
     {
+        MEASURE_LATENCY(AdaptPhase);
+        for (const auto &l : listeners)
+            l->adapting(files);
 #ifdef MULTIPLE_EXECUTORS
-        const std::lock_guard<std::mutex> lock(mtx);
+        if (background_replanning && running && !pending_requirements)
+            capture_plan();
 #endif
         while (!slv.get_sat_core().root_level()) // we go at root level..
             slv.get_sat_core().pop();
@@ -272,10 +1160,13 @@ namespace ratio::executor
         pending_requirements = true;
     }
 
-    PLEXA_EXPORT void executor::failure(const std::unordered_set<const ratio::atom *> &atoms)
+    void executor::fail(const std::unordered_set<const ratio::atom *> &atoms)
     {
+        MEASURE_LATENCY(FailurePhase);
+        for (const auto &l : listeners)
+            l->failed(atoms);
 #ifdef MULTIPLE_EXECUTORS
-        const std::lock_guard<std::mutex> lock(mtx);
+        plan_captured = false; // the failure changes the plan..
 #endif
         for (const auto &atm : atoms)
             cnfl.push_back(!atm->get_sigma());
@@ -284,29 +1175,166 @@ namespace ratio::executor
             throw execution_exception();
     }
 
+    void executor::restore_snapshot(const snapshot &snp)
+    {
+        // the compactions are done by the executing thread, hence the snapshot is checked only when restored..
+        if (snp.compactions != compactions)
+            throw std::invalid_argument("the snapshot refers to retired atoms..");
+#ifdef MULTIPLE_EXECUTORS
+        plan_captured = false; // the restored plan is solved within the tick..
+#endif
+        while (!slv.get_sat_core().root_level()) // we go at root level, retracting the bounds enforced after the snapshot..
+            slv.get_sat_core().pop();
+
+        current_time = snp.current_time;
+        ended_atoms = snp.ended_atoms;
+        pulses = snp.pulses;
+        ++timelines_changes;
+
+        // we restore the adaptations in place, keeping the arena of the current ones..
+        dirty_adaptations.clear();
+        pending_end_delays = 0;
+        for (size_t idx = 0; idx < atoms.size(); ++idx)
+        {
+            const auto atm = std::as_const(atoms)[idx].atm;
+            if (!atm)
+                continue; // the index is free..
+            if (idx < snp.atoms.size() && snp.atoms[idx].atm == atm)
+            {
+                atoms[idx] = snp.atoms[idx];
+                atoms[idx].dirty = false;
+                adaptations[idx] = *snp.adaptations[idx];
+            }
+            else
+            { // the atom has been created after the snapshot..
+                atoms[idx].start_delay.reset();
+                atoms[idx].end_delay.reset();
+                atoms[idx].pulses.reset();
+                atoms[idx].dirty = false;
+                set_dirty(idx);
+            }
+            atoms[idx].executing = npos;
+            if (atoms[idx].end_delay)
+                ++pending_end_delays;
+        }
+        executing = std::make_shared<std::vector<const ratio::atom *>>();
+        executing_set.clear();
+        for (const auto &atm : *snp.executing)
+            set_executing(index_of(*atm));
+        snapshot_adaptations = snp.adaptations;
+        // the restored timelines do not track the atoms created after the snapshot, and the values changed since the snapshot are not known..
+        rebuild = true;
+
+        pending_requirements = true;
+    }
+
+    void executor::apply_delays(const std::vector<atom_delay> &delays)
+    {
+        // we first store the new lower bounds, so that `propagate` enforces them when `xi`, or the atoms, are (re)activated..
+        std::vector<std::pair<const atom_delay *, utils::inf_rational>> lbs;
+        lbs.reserve(delays.size());
+        for (const auto &dl : delays)
+        {
+            auto &xpr = slv.is_impulse(*dl.atm) ? dl.atm->get(RATIO_AT) : dl.atm->get(dl.starting ? RATIO_START : RATIO_END);
+            if (slv.is_constant(xpr))
+                throw execution_exception(); // we can't delay constants..
+            const auto lb = slv.arith_value(xpr) + (units_per_tick > dl.delay ? units_per_tick : dl.delay);
+            auto &adapt = adaptations[dl.idx];
+            if (auto bnds = adapt.get_bounds(static_cast<ratio::arith_item &>(*xpr)))
+            { // we update the lower bound..
+                if (bnds->lb < lb)
+                    bnds->lb = lb;
+            }
+            else // we have to add new bounds..
+                adapt.arith_bnds.emplace_back(static_cast<ratio::arith_item &>(*xpr), lb, slv.arith_bounds(xpr).second);
+            set_dirty(dl.idx);
+            lbs.emplace_back(&dl, lb);
+        }
+
+        // we then enforce the new lower bounds of the active atoms..
+        if (!slv.get_sat_core().root_level())
+        { // by assuming `xi` again, on a new decision level, all the active bounds are propagated together, and a conflict among them is analyzed once..
+            while (!slv.get_sat_core().root_level() && slv.get_sat_core().value(xi) != utils::Undefined)
+                slv.get_sat_core().pop();
+            if (slv.get_sat_core().value(xi) == utils::Undefined)
+            {
+                if (!slv.get_sat_core().assume(xi))
+                    throw execution_exception();
+                return;
+            }
+        }
+        // `xi` holds at root level: the bounds are enforced one at a time, as the LRA theory has no multi-bound update..
+        for (const auto &[dl, lb] : lbs)
+        {
+            const auto &sigma_xi = adaptations[dl->idx].sigma_xi;
+            if (slv.get_sat_core().value(sigma_xi) != utils::True)
+                continue; // the lower bound will be enforced by `propagate` when the atom is (re)activated..
+            auto &xpr = slv.is_impulse(*dl->atm) ? dl->atm->get(RATIO_AT) : dl->atm->get(dl->starting ? RATIO_START : RATIO_END);
+            if (xpr->get_type() == slv.get_real_type())
+            { // we have a real variable..
+                if (!slv.get_lra_theory().set_lb(slv.get_lra_theory().new_var(static_cast<ratio::arith_item &>(*xpr).get_lin()), lb, sigma_xi))
+                { // setting the lower bound caused a conflict..
+                    swap_conflict(slv.get_lra_theory());
+                    if (!backtrack_analyze_and_backjump())
+                        throw execution_exception();
+                }
+            }
+            else
+                throw std::runtime_error("not implemented yet");
+        }
+    }
+
     bool executor::propagate(const semitone::lit &p) noexcept
     {
+        MEASURE_LATENCY(PropagatePhase);
         if (p == xi)
         { // we propagate the active bounds..
-            for (const auto &adapt : adaptations)
-                if (slv.get_sat_core().value(adapt.second.sigma_xi) == utils::True)
-                    for (const auto &bnds : adapt.second.bounds)
-                        if (!propagate_bounds(*bnds.first, *bnds.second, adapt.second.sigma_xi))
-                            return false;
+            for (const auto &idx : active_adaptations)
+                if (!propagate_bounds(adaptations[idx], adaptations[idx].sigma_xi))
+                    return false;
+        }
+        else if (const auto idx = variable(p) < var_index.size() ? var_index[variable(p)] : npos; idx == npos)
+            return true; // the variable is not bound to an atom, or the atom has been retired..
+        else if (variable(p) != variable(adaptations[idx].sigma_xi))
+        { // an atom has been (de)activated: its pulses must be updated at the next solution..
+            set_moved(idx);
+            assigned_sigmas.push_back(idx);
         }
         else if (slv.get_sat_core().value(variable(p)) == utils::True)
         { // an atom has been activated..
-            const auto atm = all_atoms.at(variable(p));
-            const auto &adapt = adaptations.at(atm);
-            for (const auto &bnds : adapt.bounds)
-                if (!propagate_bounds(*bnds.first, *bnds.second, p))
-                    return false;
+            const auto &adapt = adaptations[idx];
+            if (!adapt.empty()) // we watch the adaptation until the atom is deactivated..
+                active_adaptations.push_back(idx);
+            return propagate_bounds(adapt, p);
         }
         return true;
     }
 
+    void executor::push() noexcept { layers.emplace_back(active_adaptations.size(), assigned_sigmas.size()); }
+
+    void executor::pop() noexcept
+    { // we forget the adaptations which have been activated at the popped level..
+        active_adaptations.resize(layers.back().first);
+        // the atoms whose sigma is unassigned might not be active anymore..
+        for (size_t i = layers.back().second; i < assigned_sigmas.size(); ++i)
+            set_moved(assigned_sigmas[i]);
+        assigned_sigmas.resize(layers.back().second);
+        layers.pop_back();
+    }
+
+    void executor::lra_value_change(const semitone::var &x)
+    {
+        if (const auto atms = time_vars.find(x); atms != time_vars.cend())
+            for (const auto &idx : atms->second) // the atoms have moved: their pulses must be updated at the next solution..
+                set_moved(idx);
+    }
+
     void executor::started_solving()
     {
+#ifdef MULTIPLE_EXECUTORS
+        if (replanning)
+            return; // the listeners have already been notified..
+#endif
         if (state != executor_state::Reasoning)
         {
             state = executor_state::Adapting;
@@ -315,6 +1343,12 @@ namespace ratio::executor
         }
     }
 
+    void executor::current_resolver(const ratio::resolver &r)
+    {
+        if (warm_start)
+            chosen_resolvers.push_back(r.get_rho());
+    }
+
     void executor::solution_found()
     {
         switch (slv.get_sat_core().value(xi))
@@ -333,7 +1367,26 @@ namespace ratio::executor
             slv.solve();
             break;
         }
-        build_timelines();
+        if (warm_start)
+        { // we store the decisions of the new solution, for warm-starting the next one..
+            std::vector<semitone::lit> c_decisions;
+            std::unordered_set<semitone::var> decided;
+            for (const auto &decisions : {&warm_decisions, &chosen_resolvers})
+                for (const auto &d : *decisions)
+                    if (slv.get_sat_core().value(d) == utils::True && decided.insert(variable(d)).second)
+                        c_decisions.push_back(d);
+            warm_decisions = std::move(c_decisions);
+            chosen_resolvers.clear();
+        }
+#ifdef MULTIPLE_EXECUTORS
+        if (replanning)
+            return; // the timelines are swapped in by the executing thread..
+#endif
+
+        if (incremental && !rebuild)
+            update_timelines();
+        else
+            build_timelines();
 
         state = running ? executor_state::Executing : executor_state::Idle;
         for (const auto &l : listeners)
@@ -341,9 +1394,16 @@ namespace ratio::executor
     }
     void executor::inconsistent_problem()
     {
-        s_atms.clear();
-        e_atms.clear();
+#ifdef MULTIPLE_EXECUTORS
+        if (replanning)
+        { // the failure is notified by the executing thread..
+            replanning_failed = true;
+            return;
+        }
+#endif
         pulses.clear();
+        ++timelines_changes;
+        rebuild = true; // the tracked atoms are no more consistent with the timelines..
 
         state = executor_state::Failed;
         for (const auto &l : listeners)
@@ -359,89 +1419,297 @@ namespace ratio::executor
             const auto sigma_xi = slv.get_sat_core().new_var();
             // we bind the sigma variable for propagating the bounds..
             bind(sigma_xi);
-            all_atoms.emplace(sigma_xi, &atm);
             // either the atom is not active, or the xi variable is false, or the execution bounds must be enforced..
             [[maybe_unused]] bool nc = slv.get_sat_core().new_clause({!atm.get_sigma(), !xi, semitone::lit(sigma_xi)});
             assert(nc);
-            auto [at_adapt, added] = adaptations.emplace(&atm, semitone::lit(sigma_xi));
+            const auto idx = index_atom(atm, sigma_xi);
+            if (slv.is_impulse(atm) || slv.is_interval(atm))
+            { // we track the new atom for updating the timelines at the next solution..
+                atoms[idx].pulses = atom_pulses();
+                set_moved(idx);
+                // we listen to the (de)activation of the atom and to the changes of its times..
+                bind(variable(atm.get_sigma()));
+                for (const auto &x : get_time_vars(atm))
+                {
+                    time_vars[x].push_back(idx);
+                    listen_lra(x);
+                }
+            }
+#ifdef MULTIPLE_EXECUTORS
+            // while replanning, the current time is being updated by the executing thread..
+            const auto &c_time = replanning ? planned_time : current_time;
+#else
+            const auto &c_time = current_time;
+#endif
 
             if (slv.is_impulse(atm))
             { // we create a new adaptation for the impulse atom..
                 auto &xpr = atm.get(RATIO_AT);
-                at_adapt->second.bounds.emplace(&*xpr, new atom_adaptation::arith_bounds(utils::inf_rational(current_time), utils::inf_rational(utils::rational::POSITIVE_INFINITY)));
+                adaptations[idx].arith_bnds.emplace_back(static_cast<ratio::arith_item &>(*xpr), utils::inf_rational(c_time), utils::inf_rational(utils::rational::POSITIVE_INFINITY));
             }
             else if (slv.is_interval(atm))
             { // we create a new adaptation for the interval atom..
                 auto &xpr = atm.get(RATIO_START);
-                at_adapt->second.bounds.emplace(&*xpr, new atom_adaptation::arith_bounds(utils::inf_rational(current_time), utils::inf_rational(utils::rational::POSITIVE_INFINITY)));
+                adaptations[idx].arith_bnds.emplace_back(static_cast<ratio::arith_item &>(*xpr), utils::inf_rational(c_time), utils::inf_rational(utils::rational::POSITIVE_INFINITY));
             }
+
+            if (!checkpointed_atoms.empty()) // we restore the adaptation of the atom from the loaded checkpoint..
+                restore_checkpointed(idx);
+        }
+    }
+
+    size_t executor::index_atom(ratio::atom &atm, const semitone::var &sigma_xi)
+    {
+        size_t idx;
+        if (!free_indices.empty())
+        { // we reuse the index of a retired atom..
+            idx = free_indices.back();
+            free_indices.pop_back();
+            atoms[idx].atm = &atm;
+            adaptations[idx] = atom_adaptation(semitone::lit(sigma_xi), arena);
+        }
+        else
+        {
+            idx = atoms.size();
+            atoms.emplace_back().atm = &atm;
+            adaptations.emplace_back(semitone::lit(sigma_xi), arena);
         }
+        // both the sigma and the sigma_xi variables lead to the index of the atom..
+        const auto sigma = variable(atm.get_sigma());
+        if (var_index.size() <= std::max(sigma, sigma_xi))
+            var_index.resize(std::max(sigma, sigma_xi) + 1, npos);
+        var_index[sigma] = idx;
+        var_index[sigma_xi] = idx;
+        set_dirty(idx);
+        return idx;
+    }
+
+    size_t executor::index_of(const ratio::atom &atm) const noexcept
+    {
+        const auto sigma = variable(atm.get_sigma());
+        return sigma < var_index.size() ? var_index[sigma] : npos;
+    }
+
+    void executor::set_executing(const size_t &idx)
+    {
+        if (atoms[idx].executing != npos)
+            return;
+        if (executing.use_count() > 1) // the executing atoms are shared with some snapshot..
+            executing = std::make_shared<std::vector<const ratio::atom *>>(*executing);
+        atoms[idx].executing = executing->size();
+        executing->push_back(atoms[idx].atm);
+        executing_set.insert(atoms[idx].atm);
+    }
+
+    void executor::unset_executing(const size_t &idx)
+    {
+        const auto pos = atoms[idx].executing;
+        if (pos == npos)
+            return;
+        if (executing.use_count() > 1) // the executing atoms are shared with some snapshot..
+            executing = std::make_shared<std::vector<const ratio::atom *>>(*executing);
+        // we move the last executing atom in place of the removed one..
+        (*executing)[pos] = executing->back();
+        atoms[index_of(*(*executing)[pos])].executing = pos;
+        executing->pop_back();
+        executing_set.erase(atoms[idx].atm);
+        atoms[idx].executing = npos;
+    }
+
+    void executor::set_dirty(const size_t &idx)
+    {
+        if (atoms[idx].dirty)
+            return;
+        atoms[idx].dirty = true;
+        dirty_adaptations.push_back(idx);
+    }
+
+    void executor::set_moved(const size_t &idx)
+    {
+        if (atoms[idx].moved)
+            return;
+        atoms[idx].moved = true;
+        moved_atoms.push_back(idx);
+    }
+
+    std::vector<semitone::var> executor::get_time_vars(const ratio::atom &atm)
+    {
+        std::vector<std::string> xpr_names;
+        if (slv.is_impulse(atm))
+            xpr_names = {RATIO_AT};
+        else if (slv.is_interval(atm))
+            xpr_names = {RATIO_START, RATIO_END};
+        std::vector<semitone::var> vars;
+        for (const auto &xpr_name : xpr_names)
+            if (const auto &xpr = atm.get(xpr_name); !slv.is_constant(xpr) && xpr->get_type() == slv.get_real_type())
+                vars.push_back(slv.get_lra_theory().new_var(static_cast<const ratio::arith_item &>(*xpr).get_lin()));
+        return vars;
     }
 
     void executor::build_timelines()
     {
-        LOG("building timelines..");
-        s_atms.clear();
-        e_atms.clear();
+        MEASURE_LATENCY(TimelinesPhase);
+        PLEXA_LOG_DEBUG("building timelines..");
+        ++timelines_changes;
         pulses.clear();
+        for (size_t idx = 0; idx < atoms.size(); ++idx)
+        {
+            atoms[idx].pulses.reset();
+            atoms[idx].moved = false;
+        }
+        moved_atoms.clear();
 
-        // we collect all the active relevant atoms..
+        // we collect all the relevant atoms and the pulses of the active ones..
+        std::vector<utils::inf_rational> times;
         for (const auto pred : relevant_predicates)
             for (const auto &atm : pred->get_instances())
             {
                 auto &c_atm = static_cast<ratio::atom &>(*atm);
+                const auto idx = index_of(c_atm);
+                if (idx == npos)
+                    continue; // the atom has been retired, or it has been created before the executor, hence it can't be executed..
                 if (slv.get_sat_core().value(c_atm.get_sigma()) == utils::True)
                 { // the atom is active..
-                    if (slv.is_impulse(c_atm))
-                    {
-                        auto at = slv.arith_value(c_atm.get(RATIO_AT));
-                        if (at < current_time)
-                            continue; // this atom is already in the past..
-                        s_atms[at].insert(&c_atm);
-                        e_atms[at].insert(&c_atm);
-                        pulses.insert(at);
-                    }
-                    else if (slv.is_interval(c_atm))
-                    {
-                        auto end = slv.arith_value(c_atm.get(RATIO_END));
-                        if (end < current_time)
-                            continue; // this atom is already in the past..
-                        auto start = slv.arith_value(c_atm.get(RATIO_START));
-                        if (start >= current_time)
-                        {
-                            s_atms[start].insert(&c_atm);
-                            pulses.insert(start);
-                        }
-                        e_atms[end].insert(&c_atm);
-                        pulses.insert(end);
-                    }
+                    const auto pls = compute_pulses(c_atm);
+                    if (!pls.end)
+                        continue; // this atom is already in the past..
+                    if (pls.start)
+                        times.push_back(*pls.start);
+                    times.push_back(*pls.end);
+                    atoms[idx].pulses = pls;
+                }
+                else // the atom might become active in a future solution..
+                    atoms[idx].pulses = atom_pulses();
+            }
+
+        // we create the pulses in decreasing order, so that the next pulse is always at the back..
+        std::sort(times.begin(), times.end(), [](const utils::inf_rational &lhs, const utils::inf_rational &rhs)
+                  { return lhs > rhs; });
+        times.erase(std::unique(times.begin(), times.end()), times.end());
+        for (const auto &time : times)
+            pulses.emplace_back(time);
+        // we populate the pulses with the starting/ending atoms..
+        for (const auto &c_atm : atoms)
+            if (c_atm.pulses)
+                add_pulses(*c_atm.atm, *c_atm.pulses);
+        rebuild = false;
+    }
+
+    void executor::update_timelines()
+    {
+        MEASURE_LATENCY(TimelinesPhase);
+        PLEXA_LOG_DEBUG("updating timelines..");
+        ++timelines_changes;
+        // only the atoms whose sigma or time values have changed since the last update are visited..
+        for (const auto &idx : moved_atoms)
+        {
+            auto &c_atm = atoms[idx];
+            c_atm.moved = false;
+            if (c_atm.pulses) // the atom is tracked, i.e., it has not ended nor been retired yet..
+                if (const auto c_pls = compute_pulses(*c_atm.atm); c_pls != *c_atm.pulses)
+                { // the atom has been (de)activated or moved: we update its pulses..
+                    remove_pulses(*c_atm.atm, *c_atm.pulses);
+                    add_pulses(*c_atm.atm, c_pls);
+                    c_atm.pulses = c_pls;
                 }
+        }
+        moved_atoms.clear();
+    }
+
+    executor::atom_pulses executor::compute_pulses(const ratio::atom &atm) const
+    {
+        atom_pulses pls;
+        if (slv.get_sat_core().value(atm.get_sigma()) != utils::True)
+            return pls; // the atom is not active..
+        if (slv.is_impulse(atm))
+        {
+            auto at = slv.arith_value(atm.get(RATIO_AT));
+            if (at < current_time)
+                return pls; // this atom is already in the past..
+            pls.start = at;
+            pls.end = at;
+        }
+        else if (slv.is_interval(atm))
+        {
+            auto end = slv.arith_value(atm.get(RATIO_END));
+            if (end < current_time)
+                return pls; // this atom is already in the past..
+            if (auto start = slv.arith_value(atm.get(RATIO_START)); start >= current_time)
+                pls.start = start;
+            pls.end = end;
+        }
+        return pls;
+    }
+
+    void executor::add_pulses(ratio::atom &atm, const atom_pulses &pls)
+    {
+        if (pls.start)
+            get_pulse(*pls.start).starting.insert(&atm);
+        if (pls.end)
+            get_pulse(*pls.end).ending.insert(&atm);
+    }
+
+    void executor::remove_pulses(ratio::atom &atm, const atom_pulses &pls)
+    {
+        if (pls.start)
+            if (const auto pos = find_pulse(*pls.start); pos != pulses.end_position())
+            {
+                auto &c_pulse = pulses.get(pos);
+                c_pulse.starting.erase(&atm);
+                if (c_pulse.starting.empty() && c_pulse.ending.empty()) // nothing happens at this pulse anymore..
+                    pulses.erase(pos);
+            }
+        if (pls.end)
+            if (const auto pos = find_pulse(*pls.end); pos != pulses.end_position())
+            {
+                auto &c_pulse = pulses.get(pos);
+                c_pulse.ending.erase(&atm);
+                if (c_pulse.starting.empty() && c_pulse.ending.empty()) // nothing happens at this pulse anymore..
+                    pulses.erase(pos);
             }
     }
 
-    bool executor::propagate_bounds(const riddle::item &itm, const atom_adaptation::item_bounds &bounds, const semitone::lit &reason)
+    cow_sequence<executor::pulse>::position executor::find_pulse(const utils::inf_rational &time) const
+    {
+        // the pulses are sorted in decreasing order..
+        const auto pos = pulses.lower_bound(time, [](const pulse &p, const utils::inf_rational &t)
+                                            { return p.time > t; });
+        return pos != pulses.end_position() && pulses.get(pos).time == time ? pos : pulses.end_position();
+    }
+
+    executor::pulse &executor::get_pulse(const utils::inf_rational &time)
     {
-        if (const auto ba = dynamic_cast<const atom_adaptation::bool_bounds *>(&bounds))
+        // the pulses are sorted in decreasing order..
+        const auto pos = pulses.lower_bound(time, [](const pulse &p, const utils::inf_rational &t)
+                                            { return p.time > t; });
+        if (pos != pulses.end_position() && std::as_const(pulses).get(pos).time == time)
+            return pulses.get(pos);
+        return pulses.emplace(pos, time);
+    }
+
+    bool executor::propagate_bounds(const atom_adaptation &adapt, const semitone::lit &reason)
+    {
+        for (const auto &bnds : adapt.bool_bnds)
         {
-            const auto var = static_cast<const ratio::bool_item *>(&itm)->get_lit();
+            const auto var = bnds.itm->get_lit();
             const auto val = slv.get_sat_core().value(var);
             if (val == utils::Undefined)
                 record({var, !reason});
-            else if (val != ba->val)
+            else if (val != bnds.val)
             { // we have a conflict..
                 cnfl.push_back(var);
                 cnfl.push_back(!reason);
                 return false;
             }
         }
-        else if (const auto aa = dynamic_cast<const atom_adaptation::arith_bounds *>(&bounds))
+        for (const auto &bnds : adapt.arith_bnds)
         {
-            if (static_cast<const ratio::arith_item &>(itm).get_lin().vars.empty())
-                return true; // we have a constant: nothing to propagate..
-            const auto var = slv.get_lra_theory().new_var(static_cast<const ratio::arith_item &>(itm).get_lin());
-            if (itm.get_type() == slv.get_real_type())
+            if (bnds.itm->get_lin().vars.empty())
+                continue; // we have a constant: nothing to propagate..
+            const auto var = slv.get_lra_theory().new_var(bnds.itm->get_lin());
+            if (bnds.itm->get_type() == slv.get_real_type())
             { // we have a real variable..
-                if (!slv.get_lra_theory().set_lb(var, aa->lb, reason) || !slv.get_lra_theory().set_ub(var, aa->ub, reason))
+                if (!slv.get_lra_theory().set_lb(var, bnds.lb, reason) || !slv.get_lra_theory().set_ub(var, bnds.ub, reason))
                 { // setting the bounds caused a conflict..
                     swap_conflict(slv.get_lra_theory());
                     return false;
@@ -450,15 +1718,15 @@ namespace ratio::executor
             else
                 throw std::runtime_error("not implemented yet..");
         }
-        else if (const auto va = dynamic_cast<const atom_adaptation::var_bounds *>(&bounds))
+        for (const auto &bnds : adapt.var_bnds)
         {
-            const auto var = static_cast<const ratio::enum_item &>(itm).get_var();
+            const auto var = bnds.itm->get_var();
             const auto val = slv.get_ov_theory().value(var);
             if (val.size() > 1)
-                record({slv.get_ov_theory().allows(var, va->val), !reason});
-            else if (*val.begin() != &va->val)
+                record({slv.get_ov_theory().allows(var, *bnds.val), !reason});
+            else if (*val.begin() != bnds.val)
             { // we have a conflict..
-                cnfl.push_back(slv.get_ov_theory().allows(var, va->val));
+                cnfl.push_back(slv.get_ov_theory().allows(var, *bnds.val));
                 cnfl.push_back(!reason);
                 return false;
             }
@@ -466,25 +1734,25 @@ namespace ratio::executor
         return true;
     }
 
-    void executor::reset_relevant_predicates()
+    void executor::update_relevant_predicates()
     {
-        relevant_predicates.clear();
+        // the types are never removed nor extended once declared, hence we classify only the newly declared ones..
         for (const auto &pred : slv.get_predicates())
-            if (slv.is_impulse(pred.get()) || slv.is_interval(pred.get()))
+            if (classified_types.insert(&pred.get()).second && (slv.is_impulse(pred.get()) || slv.is_interval(pred.get())))
                 relevant_predicates.insert(&pred.get());
         std::queue<riddle::complex_type *> q;
         for (const auto &tp : slv.get_types())
-            if (!tp.get().is_primitive())
+            if (!tp.get().is_primitive() && classified_types.insert(&tp.get()).second)
                 if (auto ct = dynamic_cast<riddle::complex_type *>(&tp.get()))
                     q.push(ct);
         while (!q.empty())
-        {
+        { // the nested types and predicates of a new type are new as well..
             for (const auto &st : q.front()->get_types())
-                if (!st.get().is_primitive())
+                if (!st.get().is_primitive() && classified_types.insert(&st.get()).second)
                     if (auto ct = dynamic_cast<riddle::complex_type *>(&st.get()))
                         q.push(ct);
             for (const auto &pred : q.front()->get_predicates())
-                if (slv.is_impulse(pred.get()) || slv.is_interval(pred.get()))
+                if (classified_types.insert(&pred.get()).second && (slv.is_impulse(pred.get()) || slv.is_interval(pred.get())))
                     relevant_predicates.insert(&pred.get());
             q.pop();
         }
@@ -0,0 +1,74 @@
+#include "executor_log.h"
+#include <iostream>
+#include <chrono>
+
+namespace ratio::executor::logging
+{
+    constexpr auto flush_period = std::chrono::milliseconds(10); // the maximum delay between logging a message and writing it..
+
+    PLEXA_EXPORT async_logger &async_logger::get_instance()
+    {
+        static async_logger logger;
+        return logger;
+    }
+
+    async_logger::async_logger() : slots(new slot[capacity]), out(&std::clog)
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            slots[i].seq.store(i, std::memory_order_relaxed);
+        th = std::thread(&async_logger::run, this);
+    }
+
+    PLEXA_EXPORT async_logger::~async_logger()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_one();
+        if (th.joinable())
+            th.join();
+    }
+
+    bool async_logger::consume(std::ostream &os)
+    {
+        auto &s = slots[head & (capacity - 1)];
+        if (s.seq.load(std::memory_order_acquire) != head + 1)
+            return false; // the slot has not been published yet..
+        os << '[' << to_string(s.lvl) << "] ";
+        if (s.format)
+            s.format(os, s.args);
+        os << '\n';
+        // the slot is now free for the producers of the next round..
+        s.seq.store(head + capacity, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    void async_logger::run()
+    {
+        size_t reported_drops = 0;
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true)
+        {
+            const bool last = stopping;
+            lock.unlock();
+            auto &os = *out.load(std::memory_order_acquire);
+            bool consumed = false;
+            while (consume(os))
+                consumed = true;
+            if (const auto c_dropped = dropped.load(std::memory_order_relaxed); c_dropped != reported_drops)
+            { // we report the messages dropped since the last report..
+                os << "[WARN] " << c_dropped - reported_drops << " log messages dropped\n";
+                reported_drops = c_dropped;
+                consumed = true;
+            }
+            if (consumed)
+                os.flush();
+            lock.lock();
+            if (last)
+                return; // the messages logged before stopping have been written..
+            cv.wait_for(lock, flush_period);
+        }
+    }
+} // namespace ratio::executor::logging
@@ -0,0 +1,214 @@
+#include "executor_scheduler.h"
+#include <stdexcept>
+
+namespace ratio::executor
+{
+    constexpr size_t max_idle_ticks = 1 << 20; // the maximum number of ticks to sleep through before asking again..
+
+    PLEXA_EXPORT executor_scheduler::executor_scheduler(const size_t &n_workers, std::function<void(executor &, std::exception_ptr)> on_error) : on_error(on_error)
+    {
+        if (!n_workers)
+            throw std::invalid_argument("the scheduler requires at least one worker..");
+        workers.reserve(n_workers);
+        for (size_t i = 0; i < n_workers; ++i)
+            workers.push_back(std::make_unique<worker>());
+        for (size_t i = 0; i < n_workers; ++i)
+            workers[i]->th = std::thread(&executor_scheduler::work, this, i);
+    }
+    PLEXA_EXPORT executor_scheduler::~executor_scheduler() { stop(); }
+
+    PLEXA_EXPORT void executor_scheduler::add(executor &exec, const std::chrono::nanoseconds &tick_dur)
+    {
+        auto jb = std::make_shared<job>(exec, tick_dur, clock::now() + tick_dur);
+        size_t w;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!jobs.emplace(&exec, jb).second)
+                throw std::invalid_argument("the executor is already scheduled..");
+            w = next_worker++ % workers.size();
+        }
+        schedule(jb, jb->next_tick, 0, w);
+    }
+
+    PLEXA_EXPORT void executor_scheduler::remove(executor &exec)
+    {
+        std::shared_ptr<job> jb;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto it = jobs.find(&exec);
+            if (it == jobs.cend())
+                return;
+            jb = it->second;
+            jobs.erase(it);
+        }
+        // we wait for the current tick, if any, to complete..
+        std::lock_guard<std::recursive_mutex> lock(jb->mtx);
+        jb->removed = true;
+    }
+
+    PLEXA_EXPORT void executor_scheduler::wake(executor &exec)
+    {
+        std::shared_ptr<job> jb;
+        size_t w;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto it = jobs.find(&exec);
+            if (it == jobs.cend())
+                return;
+            jb = it->second;
+            w = next_worker++ % workers.size();
+        }
+        size_t generation;
+        clock::time_point deadline;
+        {
+            std::lock_guard<std::recursive_mutex> lock(jb->mtx);
+            if (jb->removed)
+                return;
+            generation = ++jb->generation; // we invalidate the entry which sleeps through the idle ticks..
+            deadline = jb->next_tick;
+        }
+        schedule(jb, deadline, generation, w);
+    }
+
+    PLEXA_EXPORT void executor_scheduler::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mtx);
+            stopping = true;
+        }
+        sleep_cv.notify_all();
+        for (auto &wk : workers)
+            if (wk->th.joinable())
+                wk->th.join();
+    }
+
+    void executor_scheduler::schedule(const std::shared_ptr<job> &jb, const clock::time_point &deadline, const size_t &generation, const size_t &w)
+    {
+        {
+            std::lock_guard<std::mutex> lock(workers[w]->mtx);
+            workers[w]->heap.push_back({deadline, jb, generation});
+            std::push_heap(workers[w]->heap.begin(), workers[w]->heap.end(), std::greater<entry>());
+        }
+        {
+            // we make sure that no worker is between computing its sleep deadline and going to sleep..
+            std::lock_guard<std::mutex> lock(sleep_mtx);
+        }
+        sleep_cv.notify_one();
+    }
+
+    void executor_scheduler::work(const size_t &w)
+    {
+        entry e;
+        while (!stopping)
+        {
+            if (next_entry(w, e))
+            {
+                run(e, w);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mtx);
+            if (stopping)
+                return;
+            // we sleep until the most urgent entry, whichever worker owns it, becomes due..
+            auto deadline = clock::time_point::max();
+            for (const auto &wk : workers)
+            {
+                std::lock_guard<std::mutex> wk_lock(wk->mtx);
+                if (!wk->heap.empty())
+                    deadline = std::min(deadline, wk->heap.front().deadline);
+            }
+            if (deadline == clock::time_point::max())
+                sleep_cv.wait(lock);
+            else if (deadline > clock::now())
+                sleep_cv.wait_until(lock, deadline);
+        }
+    }
+
+    bool executor_scheduler::next_entry(const size_t &w, entry &e)
+    {
+        const auto now = clock::now();
+        const auto pop = [&e](worker &wk)
+        {
+            std::pop_heap(wk.heap.begin(), wk.heap.end(), std::greater<entry>());
+            e = std::move(wk.heap.back());
+            wk.heap.pop_back();
+        };
+        { // we first look at our own entries..
+            auto &wk = *workers[w];
+            std::lock_guard<std::mutex> lock(wk.mtx);
+            if (!wk.heap.empty() && wk.heap.front().deadline <= now)
+            {
+                pop(wk);
+                return true;
+            }
+        }
+        while (true)
+        { // we then steal the most urgent due entry among the tops of the other workers..
+            size_t best = w;
+            auto best_deadline = now;
+            for (size_t i = 1; i < workers.size(); ++i)
+            {
+                const auto c_w = (w + i) % workers.size();
+                std::lock_guard<std::mutex> lock(workers[c_w]->mtx);
+                if (!workers[c_w]->heap.empty() && workers[c_w]->heap.front().deadline <= best_deadline)
+                {
+                    best = c_w;
+                    best_deadline = workers[c_w]->heap.front().deadline;
+                }
+            }
+            if (best == w)
+                return false; // no other worker has a due entry..
+
+            auto &wk = *workers[best];
+            std::lock_guard<std::mutex> lock(wk.mtx);
+            if (!wk.heap.empty() && wk.heap.front().deadline <= now)
+            {
+                pop(wk);
+                return true;
+            }
+            // the entry has been taken in the meanwhile: we look again..
+        }
+    }
+
+    void executor_scheduler::run(const entry &e, const size_t &w)
+    {
+        auto &jb = *e.jb;
+        size_t generation;
+        clock::time_point deadline;
+        {
+            std::unique_lock<std::recursive_mutex> lock(jb.mtx);
+            if (jb.removed || e.generation != jb.generation)
+                return; // the entry is stale..
+
+            // we coalesce the ticks elapsed since the first tick not yet performed, including the idle ones..
+            const auto ticks = 1 + static_cast<size_t>((clock::now() - jb.next_tick) / jb.tick_duration);
+            try
+            {
+                jb.exec.tick(ticks);
+            }
+            catch (...)
+            {
+                jb.removed = true;
+                lock.unlock();
+                {
+                    std::lock_guard<std::mutex> j_lock(mtx);
+                    if (auto it = jobs.find(&jb.exec); it != jobs.cend() && it->second == e.jb)
+                        jobs.erase(it);
+                }
+                if (on_error)
+                    on_error(jb.exec, std::current_exception());
+                return;
+            }
+            jb.next_tick += jb.tick_duration * static_cast<std::chrono::nanoseconds::rep>(ticks);
+            if (jb.removed)
+                return; // the executor has been removed by one of its listeners..
+
+            // we sleep through the idle ticks, unless the executor has been woken while ticking..
+            const size_t idle_ticks = e.generation == jb.generation ? std::min(jb.exec.get_idle_ticks(), max_idle_ticks) : 0;
+            generation = ++jb.generation;
+            deadline = jb.next_tick + jb.tick_duration * static_cast<std::chrono::nanoseconds::rep>(idle_ticks);
+        }
+        schedule(e.jb, deadline, generation, w);
+    }
+} // namespace ratio::executor
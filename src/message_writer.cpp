@@ -0,0 +1,87 @@
+#include "message_writer.h"
+#include <charconv>
+
+namespace ratio::executor
+{
+    PLEXA_EXPORT std::string_view message_writer::executor_state_changed(const executor &exec)
+    {
+        begin("executor_state_changed", exec);
+        buffer += ",\"state\":\"";
+        buffer += to_string(exec.get_state());
+        buffer += "\"}";
+        return buffer;
+    }
+
+    PLEXA_EXPORT std::string_view message_writer::tick(const executor &exec, const utils::rational &time)
+    {
+        begin("tick", exec);
+        buffer += ",\"time\":";
+        write(time);
+        buffer += '}';
+        return buffer;
+    }
+
+    PLEXA_EXPORT std::string_view message_writer::starting(const executor &exec, const std::unordered_set<ratio::atom *> &atoms)
+    {
+        begin("starting", exec);
+        write_atoms("starting", atoms);
+        return buffer;
+    }
+    PLEXA_EXPORT std::string_view message_writer::start(const executor &exec, const std::unordered_set<ratio::atom *> &atoms)
+    {
+        begin("start", exec);
+        write_atoms("start", atoms);
+        return buffer;
+    }
+    PLEXA_EXPORT std::string_view message_writer::ending(const executor &exec, const std::unordered_set<ratio::atom *> &atoms)
+    {
+        begin("ending", exec);
+        write_atoms("ending", atoms);
+        return buffer;
+    }
+    PLEXA_EXPORT std::string_view message_writer::end(const executor &exec, const std::unordered_set<ratio::atom *> &atoms)
+    {
+        begin("end", exec);
+        write_atoms("end", atoms);
+        return buffer;
+    }
+
+    void message_writer::begin(const char *type, const executor &exec)
+    {
+        buffer.clear();
+        buffer += "{\"type\":\"";
+        buffer += type;
+        buffer += "\",\"solver_id\":";
+        write(get_id(exec.get_solver()));
+    }
+
+    void message_writer::write_atoms(const char *key, const std::unordered_set<ratio::atom *> &atoms)
+    {
+        buffer += ",\"";
+        buffer += key;
+        buffer += "\":[";
+        for (auto it = atoms.cbegin(); it != atoms.cend(); ++it)
+        {
+            if (it != atoms.cbegin())
+                buffer += ',';
+            write(get_id(**it));
+        }
+        buffer += "]}";
+    }
+
+    void message_writer::write(const utils::rational &r)
+    {
+        buffer += "{\"num\":";
+        write(r.numerator());
+        buffer += ",\"den\":";
+        write(r.denominator());
+        buffer += '}';
+    }
+
+    template <typename T>
+    void message_writer::write(T val)
+    {
+        char str[24];
+        buffer.append(str, std::to_chars(str, str + sizeof(str), val).ptr);
+    }
+} // namespace ratio::executor
@@ -1,29 +1,119 @@
 #include "timer.h"
-#include <chrono>
+#include <algorithm>
 
 namespace ratio::time
 {
-    timer::timer(const size_t &tick_dur, std::function<void(void)> f) : tick_duration(tick_dur), fun(f) {}
+    constexpr size_t max_idle_ticks = 1 << 20; // the maximum number of ticks to sleep through before asking again..
 
-    void timer::start()
+    template <typename Clock>
+    basic_timer<Clock>::basic_timer(const size_t &tick_dur, std::function<void(void)> f, const overrun_policy &policy) : basic_timer(std::chrono::milliseconds(tick_dur), f, policy) {}
+    template <typename Clock>
+    basic_timer<Clock>::basic_timer(const std::chrono::nanoseconds &tick_dur, std::function<void(void)> f, const overrun_policy &policy) : basic_timer(tick_dur, [f](size_t) { f(); }, nullptr, policy) {}
+    template <typename Clock>
+    basic_timer<Clock>::basic_timer(const size_t &tick_dur, std::function<void(size_t)> f, std::function<size_t(void)> idle, const overrun_policy &policy) : basic_timer(std::chrono::milliseconds(tick_dur), f, idle, policy) {}
+    template <typename Clock>
+    basic_timer<Clock>::basic_timer(const std::chrono::nanoseconds &tick_dur, std::function<void(size_t)> f, std::function<size_t(void)> idle, const overrun_policy &policy) : tick_duration(tick_dur), fun(f), idle(idle), policy(policy) {}
+
+    template <typename Clock>
+    void basic_timer<Clock>::start()
     {
         if (executing.load(std::memory_order_acquire))
             stop();
         executing.store(true, std::memory_order_release);
-        tick_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(tick_duration);
+        tick_time = Clock::now() + tick_duration;
         th = std::thread([this]()
                          {
+            size_t ticks = 1, missed = 0;
             while (executing.load(std::memory_order_acquire)) {
-                fun();
-                std::this_thread::sleep_until(tick_time);
-                tick_time += std::chrono::milliseconds(tick_duration);
+                if (policy == Burst)
+                    for (; missed && executing.load(std::memory_order_acquire); --missed)
+                        fun(1);
+                fun(ticks);
+                std::tie(ticks, missed) = wait();
+                if (policy == Coalesce)
+                    ticks += missed;
+                if (policy != Burst)
+                    missed = 0;
             } });
     }
 
-    void timer::stop()
+    template <typename Clock>
+    void basic_timer<Clock>::stop()
     {
-        executing.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            executing.store(false, std::memory_order_release);
+        }
+        cv.notify_one();
         if (th.joinable())
             th.join();
     }
-} // namespace ratio::time
\ No newline at end of file
+
+    template <typename Clock>
+    void basic_timer<Clock>::wake()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            woken = true;
+        }
+        cv.notify_one();
+    }
+
+    template <typename Clock>
+    timer_stats basic_timer<Clock>::get_stats() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return stats;
+    }
+
+    template <typename Clock>
+    std::pair<size_t, size_t> basic_timer<Clock>::wait()
+    {
+        if (Clock::now() > tick_time)
+        { // the last call lasted longer than its tick..
+            std::lock_guard<std::mutex> lock(mtx);
+            ++stats.overruns;
+        }
+        while (executing.load(std::memory_order_acquire))
+        {
+            const size_t idle_ticks = idle ? std::min(idle(), max_idle_ticks) : 0;
+            const auto wake_time = tick_time + tick_duration * static_cast<std::chrono::nanoseconds::rep>(idle_ticks);
+            std::unique_lock<std::mutex> lock(mtx);
+            if (!cv.wait_until(lock, wake_time - spin.load(std::memory_order_relaxed), [this]
+                               { return woken || !executing.load(std::memory_order_acquire); }))
+            { // we have slept through the idle ticks..
+                lock.unlock();
+                time_point now = Clock::now();
+                while (now < wake_time)
+                { // we spin until the wake time..
+                    std::this_thread::yield();
+                    now = Clock::now();
+                }
+                const size_t missed = (now - wake_time) / tick_duration;
+                const std::chrono::nanoseconds jitter = now - (wake_time + tick_duration * static_cast<std::chrono::nanoseconds::rep>(missed));
+                tick_time = wake_time + tick_duration * static_cast<std::chrono::nanoseconds::rep>(missed + 1);
+
+                lock.lock();
+                ++stats.calls;
+                stats.missed_ticks += missed;
+                ++stats.jitter_samples;
+                stats.min_jitter = std::min(stats.min_jitter, jitter);
+                stats.max_jitter = std::max(stats.max_jitter, jitter);
+                stats.total_jitter += jitter;
+                return {idle_ticks + 1, missed};
+            }
+            woken = false;
+            if (const time_point now = Clock::now(); now >= tick_time)
+            { // we have been woken after some ticks have elapsed..
+                const size_t elapsed = (now - tick_time) / tick_duration + 1;
+                tick_time += tick_duration * static_cast<std::chrono::nanoseconds::rep>(elapsed);
+                ++stats.calls; // the call follows a wake, rather than its schedule, hence it has no jitter..
+                return {elapsed, 0};
+            }
+        }
+        return {0, 0};
+    }
+
+    template class basic_timer<std::chrono::steady_clock>;
+    template class basic_timer<std::chrono::system_clock>;
+} // namespace ratio::time
@@ -0,0 +1,293 @@
+#include "timer_wheel.h"
+#include <thread>
+#include <array>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+
+namespace ratio::time
+{
+    constexpr size_t slot_bits = 6;
+    constexpr size_t slots = 1 << slot_bits; // the number of slots of each wheel..
+    constexpr size_t levels = 4;             // the number of wheels..
+    constexpr uint64_t max_range = uint64_t(1) << (slot_bits * levels);
+    constexpr uint32_t npos = UINT32_MAX;
+
+    class timer_wheel::shard
+    {
+        using clock = std::chrono::steady_clock;
+
+        struct node
+        {
+            uint64_t expiry = 0;                  // the expiration tick..
+            std::chrono::nanoseconds first = {};  // the first expiration time, since the start of the shard, before rounding..
+            std::chrono::nanoseconds period = {}; // the period, or zero for one-shot timers..
+            uint64_t expirations = 0;             // the number of expirations so far, for periodic timers..
+            std::shared_ptr<std::function<void(void)>> f;
+            uint32_t prev = npos, next = npos;
+            uint32_t slot = npos;   // the slot the node is linked into, or npos if the node is free..
+            uint32_t generation = 0; // incremented (modulo 2^24) whenever the node is freed, invalidating its identifiers..
+        };
+
+    public:
+        shard(const std::chrono::nanoseconds &resolution) : resolution(resolution), start(clock::now())
+        {
+            heads.fill(npos);
+            th = std::thread([this]()
+                             { run(); });
+        }
+        ~shard() { stop(); }
+
+        std::pair<uint32_t, uint32_t> schedule(const std::chrono::nanoseconds &delay, const std::chrono::nanoseconds &period, std::function<void(void)> f)
+        {
+            std::pair<uint32_t, uint32_t> id;
+            bool notify;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (!pending)
+                    now_tick = std::max(now_tick, current_tick()); // nothing to do for the elapsed ticks..
+                uint32_t i;
+                if (free_head != npos)
+                {
+                    i = free_head;
+                    free_head = nodes[i].next;
+                }
+                else
+                {
+                    if (nodes.size() == npos)
+                        throw std::length_error("too many timers..");
+                    i = static_cast<uint32_t>(nodes.size());
+                    nodes.emplace_back();
+                }
+                auto &n = nodes[i];
+                // we round the expiration up, so that timers never expire early..
+                n.first = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start) + std::max(delay, std::chrono::nanoseconds::zero());
+                n.expiry = std::max(now_tick + 1, to_tick(n.first));
+                n.period = std::max(period, std::chrono::nanoseconds::zero());
+                n.expirations = 0;
+                n.f = std::make_shared<std::function<void(void)>>(std::move(f));
+                // the thread must reconsider its deadline if it is sleeping indefinitely or until the next cascade..
+                const bool was_sleeping = !pending || !counts[0];
+                notify = link(i) && was_sleeping;
+                notify |= !pending++;
+                id = {i, n.generation};
+            }
+            if (notify)
+                cv.notify_one();
+            return id;
+        }
+
+        bool cancel(const uint32_t &i, const uint32_t &generation)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (i >= nodes.size() || nodes[i].generation != generation || nodes[i].slot == npos)
+                return false;
+            unlink(i);
+            release(i);
+            --pending;
+            return true;
+        }
+
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                stopping = true;
+            }
+            cv.notify_one();
+            if (th.joinable())
+                th.join();
+        }
+
+    private:
+        uint64_t current_tick() const { return static_cast<uint64_t>((clock::now() - start) / resolution); }
+        /**
+         * @brief Gets the first tick not preceding the given time, so that timers never expire early.
+         */
+        uint64_t to_tick(const std::chrono::nanoseconds &time) const { return static_cast<uint64_t>((time + resolution - std::chrono::nanoseconds(1)) / resolution); }
+
+        /**
+         * @brief Links the node into the slot of its expiration.
+         *
+         * @return true if the node is linked into the first wheel.
+         */
+        bool link(const uint32_t &i)
+        {
+            auto &n = nodes[i];
+            const auto delta = n.expiry > now_tick ? n.expiry - now_tick : 0;
+            const auto expiry = delta < max_range ? std::max(n.expiry, now_tick) : now_tick + max_range - 1; // the far timers are cascaded again..
+            size_t level = 0;
+            while (level < levels - 1 && delta >= (uint64_t(1) << (slot_bits * (level + 1))))
+                ++level;
+            n.slot = static_cast<uint32_t>(level * slots + ((expiry >> (slot_bits * level)) & (slots - 1)));
+            n.prev = npos;
+            n.next = heads[n.slot];
+            if (n.next != npos)
+                nodes[n.next].prev = i;
+            heads[n.slot] = i;
+            ++counts[level];
+            return level == 0;
+        }
+
+        void unlink(const uint32_t &i)
+        {
+            auto &n = nodes[i];
+            if (n.prev != npos)
+                nodes[n.prev].next = n.next;
+            else
+                heads[n.slot] = n.next;
+            if (n.next != npos)
+                nodes[n.next].prev = n.prev;
+            --counts[n.slot / slots];
+            n.slot = npos;
+        }
+
+        void release(const uint32_t &i)
+        {
+            auto &n = nodes[i];
+            n.f.reset();
+            n.generation = (n.generation + 1) & 0xFFFFFF;
+            n.next = free_head;
+            free_head = i;
+        }
+
+        /**
+         * @brief Detaches the list of nodes linked into the given slot.
+         */
+        uint32_t detach(const size_t &slot)
+        {
+            const auto head = heads[slot];
+            heads[slot] = npos;
+            for (auto i = head; i != npos; i = nodes[i].next)
+            {
+                --counts[slot / slots];
+                nodes[i].slot = npos;
+            }
+            return head;
+        }
+
+        /**
+         * @brief Advances the current tick, collecting the callbacks of the expired timers.
+         */
+        void advance(std::vector<std::shared_ptr<std::function<void(void)>>> &expired)
+        {
+            ++now_tick;
+            // we cascade the timers of the outer wheels whose slot has been reached..
+            for (size_t level = 1; level < levels && !(now_tick & ((uint64_t(1) << (slot_bits * level)) - 1)); ++level)
+                for (auto i = detach(level * slots + ((now_tick >> (slot_bits * level)) & (slots - 1))); i != npos;)
+                {
+                    const auto next = nodes[i].next;
+                    link(i);
+                    i = next;
+                }
+
+            for (auto i = detach(now_tick & (slots - 1)); i != npos;)
+            {
+                const auto next = nodes[i].next;
+                auto &n = nodes[i];
+                expired.push_back(n.f);
+                if (n.period.count())
+                { // each expiration is computed from the first one, rather than from the previous rounded one, so that the rounding errors do not accumulate..
+                    ++n.expirations;
+                    const auto now = resolution * static_cast<std::chrono::nanoseconds::rep>(now_tick);
+                    if (n.first + n.period * static_cast<std::chrono::nanoseconds::rep>(n.expirations) <= now) // the expirations missed while catching up are coalesced..
+                        n.expirations = static_cast<uint64_t>((now - n.first) / n.period) + 1;
+                    n.expiry = to_tick(n.first + n.period * static_cast<std::chrono::nanoseconds::rep>(n.expirations));
+                    link(i);
+                }
+                else
+                {
+                    release(i);
+                    --pending;
+                }
+                i = next;
+            }
+        }
+
+        void run()
+        {
+            std::vector<std::shared_ptr<std::function<void(void)>>> expired;
+            std::unique_lock<std::mutex> lock(mtx);
+            while (!stopping)
+            {
+                if (!pending)
+                {
+                    cv.wait(lock);
+                    continue;
+                }
+
+                const auto target = current_tick();
+                while (now_tick < target && pending && !stopping)
+                {
+                    if (!counts[0]) // we jump to the next cascade, as nothing can expire before it..
+                        now_tick = std::min(now_tick | (slots - 1), target - 1);
+                    advance(expired);
+                    if (!expired.empty())
+                    {
+                        lock.unlock();
+                        for (const auto &f : expired)
+                            (*f)();
+                        expired.clear();
+                        lock.lock();
+                    }
+                }
+
+                if (pending && !stopping)
+                {
+                    const auto next_tick = counts[0] ? now_tick + 1 : (now_tick | (slots - 1)) + 1;
+                    cv.wait_until(lock, start + resolution * static_cast<std::chrono::nanoseconds::rep>(next_tick));
+                }
+            }
+        }
+
+    private:
+        const std::chrono::nanoseconds resolution;
+        const clock::time_point start;
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::vector<node> nodes;
+        std::array<uint32_t, slots * levels> heads; // the first node of each slot..
+        std::array<size_t, levels> counts = {};     // the number of nodes in each wheel..
+        uint32_t free_head = npos;                  // the first free node..
+        size_t pending = 0;                         // the number of pending timers..
+        uint64_t now_tick = 0;                      // the last processed tick..
+        bool stopping = false;
+        std::thread th;
+    };
+
+    timer_wheel::timer_wheel(const std::chrono::nanoseconds &resolution, const size_t &threads) : resolution(resolution)
+    {
+        if (!threads || threads > 256)
+            throw std::invalid_argument("the timer wheel requires between 1 and 256 threads..");
+        if (resolution.count() <= 0)
+            throw std::invalid_argument("the resolution must be positive..");
+        shards.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+            shards.push_back(std::make_unique<shard>(resolution));
+    }
+    timer_wheel::~timer_wheel() { stop(); }
+
+    // the identifiers are made of the node index (32 bits), the shard (8 bits) and the node generation (24 bits)..
+    timer_wheel::timer_id timer_wheel::schedule(const std::chrono::nanoseconds &delay, std::function<void(void)> f) { return schedule(delay, std::chrono::nanoseconds::zero(), std::move(f)); }
+    timer_wheel::timer_id timer_wheel::schedule(const std::chrono::nanoseconds &delay, const std::chrono::nanoseconds &period, std::function<void(void)> f)
+    {
+        const auto s = next_shard.fetch_add(1, std::memory_order_relaxed) % shards.size();
+        const auto [i, generation] = shards[s]->schedule(delay, period, std::move(f));
+        return static_cast<timer_id>(i) | static_cast<timer_id>(s) << 32 | static_cast<timer_id>(generation & 0xFFFFFF) << 40;
+    }
+
+    bool timer_wheel::cancel(const timer_id &id)
+    {
+        const auto s = static_cast<size_t>((id >> 32) & 0xFF);
+        if (s >= shards.size())
+            return false;
+        return shards[s]->cancel(static_cast<uint32_t>(id), static_cast<uint32_t>(id >> 40));
+    }
+
+    void timer_wheel::stop()
+    {
+        for (auto &s : shards)
+            s->stop();
+    }
+} // namespace ratio::time
@@ -0,0 +1,470 @@
+#include "trace.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#ifdef _WIN32
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ratio::executor
+{
+    namespace trace
+    {
+        static void store_u64(uint8_t *data, uint64_t val)
+        {
+            for (size_t i = 0; i < 8; ++i)
+                data[i] = static_cast<uint8_t>(val >> (8 * i));
+        }
+        static uint64_t load_u64(const uint8_t *data)
+        {
+            uint64_t val = 0;
+            for (size_t i = 0; i < 8; ++i)
+                val |= static_cast<uint64_t>(data[i]) << (8 * i);
+            return val;
+        }
+        static uint32_t load_u32(const uint8_t *data)
+        {
+            uint32_t val = 0;
+            for (size_t i = 0; i < 4; ++i)
+                val |= static_cast<uint32_t>(data[i]) << (8 * i);
+            return val;
+        }
+
+        /**
+         * @brief An append-only file, memory-mapped where `mmap` is available.
+         *
+         * Appended bytes become visible to readers only once committed.
+         */
+        class mapped_file
+        {
+        public:
+            mapped_file(const std::string &path)
+            {
+                uint8_t header[header_size] = {};
+                std::memcpy(header, magic, sizeof(magic));
+                for (size_t i = 0; i < 4; ++i)
+                    header[4 + i] = static_cast<uint8_t>(version >> (8 * i));
+                store_u64(header + 8, header_size);
+#ifdef _WIN32
+                f = std::fopen(path.c_str(), "w+b");
+                if (!f)
+                    throw std::runtime_error("cannot create the trace file " + path);
+#else
+                fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (fd < 0)
+                    throw std::runtime_error("cannot create the trace file " + path);
+                try
+                {
+                    remap(initial_capacity);
+                }
+                catch (...)
+                {
+                    ::close(fd);
+                    throw;
+                }
+#endif
+                append(header, header_size);
+                commit();
+            }
+            ~mapped_file()
+            {
+                sync();
+#ifdef _WIN32
+                std::fclose(f);
+#else
+                ::munmap(data, capacity);
+                [[maybe_unused]] const auto res = ::ftruncate(fd, static_cast<off_t>(committed)); // we drop the unused capacity..
+                ::close(fd);
+#endif
+            }
+
+            size_t size() const { return committed; }
+
+            void append(const uint8_t *bytes, const size_t &n)
+            {
+#ifdef _WIN32
+                if (std::fwrite(bytes, 1, n, f) != n)
+                    throw std::runtime_error("cannot write the trace file..");
+#else
+                if (written + n > capacity)
+                {
+                    size_t c_capacity = capacity;
+                    while (written + n > c_capacity)
+                        c_capacity *= 2;
+                    remap(c_capacity);
+                }
+                std::memcpy(data + written, bytes, n);
+#endif
+                written += n;
+            }
+
+            void commit()
+            {
+                committed = written;
+#ifndef _WIN32
+                store_u64(data + 8, committed);
+#endif
+            }
+
+            void set_checkpoint(const uint64_t &offset)
+            {
+                checkpoint = offset;
+#ifndef _WIN32
+                store_u64(data + 16, checkpoint);
+#endif
+            }
+
+            void sync()
+            {
+#ifdef _WIN32
+                // the header is rewritten in place, the records are appended after it..
+                uint8_t bytes[16];
+                store_u64(bytes, committed);
+                store_u64(bytes + 8, checkpoint);
+                std::fseek(f, 8, SEEK_SET);
+                std::fwrite(bytes, 1, sizeof(bytes), f);
+                std::fseek(f, 0, SEEK_END);
+                std::fflush(f);
+#else
+                ::msync(data, committed, MS_SYNC);
+#endif
+            }
+
+        private:
+#ifndef _WIN32
+            void remap(const size_t &c_capacity)
+            {
+                if (data)
+                    ::munmap(data, capacity);
+                data = nullptr;
+                if (::ftruncate(fd, static_cast<off_t>(c_capacity)) != 0)
+                    throw std::runtime_error("cannot grow the trace file..");
+                void *ptr = ::mmap(nullptr, c_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (ptr == MAP_FAILED)
+                    throw std::runtime_error("cannot map the trace file..");
+                data = static_cast<uint8_t *>(ptr);
+                capacity = c_capacity;
+            }
+#endif
+
+        private:
+#ifdef _WIN32
+            std::FILE *f = nullptr;
+#else
+            static constexpr size_t initial_capacity = 1 << 20;
+            int fd = -1;
+            uint8_t *data = nullptr;
+            size_t capacity = 0;
+#endif
+            size_t written = 0, committed = 0;
+            uint64_t checkpoint = 0;
+        };
+    } // namespace trace
+
+    PLEXA_EXPORT trace_recorder::trace_recorder(executor &e, const std::string &path, const size_t &checkpoint_every) : executor_listener(e), file(std::make_unique<trace::mapped_file>(path)), checkpoint_every(checkpoint_every), current_time(e.get_current_time()) {}
+    PLEXA_EXPORT trace_recorder::~trace_recorder()
+    {
+        try
+        { // we append a final checkpoint, if the file can still grow..
+            checkpoint();
+        }
+        catch (const std::exception &e)
+        { // the records committed so far are still readable..
+            PLEXA_LOG_ERROR("cannot write the final checkpoint of the trace: ", e.what());
+        }
+    }
+
+    PLEXA_EXPORT void trace_recorder::checkpoint()
+    {
+        const auto offset = file->size();
+        record.clear();
+        write_u64(ticks);
+        write_rational(current_time);
+        write_u64(last_checkpoint);
+        commit(trace::Checkpoint);
+        last_checkpoint = offset;
+        file->set_checkpoint(last_checkpoint);
+        file->sync();
+    }
+
+    void trace_recorder::tick(const utils::rational &time)
+    {
+        current_time = time;
+        ++ticks;
+        record.clear();
+        write_rational(time);
+        commit(trace::Tick);
+        if (checkpoint_every && ticks % checkpoint_every == 0)
+            checkpoint();
+    }
+    void trace_recorder::start(const std::unordered_set<ratio::atom *> &atoms) { write_atoms(trace::Start, atoms); }
+    void trace_recorder::end(const std::unordered_set<ratio::atom *> &atoms) { write_atoms(trace::End, atoms); }
+    void trace_recorder::start_delayed(const std::unordered_map<const ratio::atom *, utils::rational> &atoms) { write_delays(trace::StartDelay, atoms); }
+    void trace_recorder::end_delayed(const std::unordered_map<const ratio::atom *, utils::rational> &atoms) { write_delays(trace::EndDelay, atoms); }
+    void trace_recorder::failed(const std::unordered_set<const ratio::atom *> &atoms)
+    {
+        record.clear();
+        write_u32(static_cast<uint32_t>(atoms.size()));
+        for (const auto &atm : atoms)
+            write_u64(variable(atm->get_sigma()));
+        commit(trace::Failure);
+    }
+    void trace_recorder::adapting(const std::string &script)
+    {
+        record.clear();
+        write_string(script);
+        commit(trace::AdaptScript);
+    }
+    void trace_recorder::adapting(const std::vector<std::string> &files)
+    {
+        record.clear();
+        write_u32(static_cast<uint32_t>(files.size()));
+        for (const auto &f : files)
+            write_string(f);
+        commit(trace::AdaptFiles);
+    }
+
+    void trace_recorder::write_atoms(const trace::record_type &type, const std::unordered_set<ratio::atom *> &atoms)
+    {
+        record.clear();
+        write_u32(static_cast<uint32_t>(atoms.size()));
+        for (const auto &atm : atoms)
+            write_u64(variable(atm->get_sigma()));
+        commit(type);
+    }
+    void trace_recorder::write_delays(const trace::record_type &type, const std::unordered_map<const ratio::atom *, utils::rational> &atoms)
+    {
+        record.clear();
+        write_u32(static_cast<uint32_t>(atoms.size()));
+        for (const auto &[atm, delay] : atoms)
+        {
+            write_u64(variable(atm->get_sigma()));
+            write_rational(delay);
+        }
+        commit(type);
+    }
+    void trace_recorder::write_u32(uint32_t val)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            record.push_back(static_cast<uint8_t>(val >> (8 * i)));
+    }
+    void trace_recorder::write_u64(uint64_t val)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            record.push_back(static_cast<uint8_t>(val >> (8 * i)));
+    }
+    void trace_recorder::write_rational(const utils::rational &val)
+    {
+        write_u64(static_cast<uint64_t>(static_cast<int64_t>(val.numerator())));
+        write_u64(static_cast<uint64_t>(static_cast<int64_t>(val.denominator())));
+    }
+    void trace_recorder::write_string(const std::string &val)
+    {
+        write_u32(static_cast<uint32_t>(val.size()));
+        record.insert(record.cend(), val.cbegin(), val.cend());
+    }
+    void trace_recorder::commit(const trace::record_type &type)
+    {
+        uint8_t header[trace::record_header_size] = {type};
+        const auto length = static_cast<uint32_t>(record.size());
+        for (size_t i = 0; i < 4; ++i)
+            header[1 + i] = static_cast<uint8_t>(length >> (8 * i));
+        file->append(header, trace::record_header_size);
+        file->append(record.data(), record.size());
+        file->commit();
+    }
+
+    PLEXA_EXPORT trace_replayer::trace_replayer(executor &e, const std::string &path) : executor_listener(e)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            throw std::invalid_argument("cannot read the trace file " + path);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        if (bytes.size() < trace::header_size || std::memcmp(bytes.data(), trace::magic, sizeof(trace::magic)) || trace::load_u32(bytes.data() + 4) != trace::version)
+            throw std::invalid_argument("invalid trace file " + path);
+        const auto committed = trace::load_u64(bytes.data() + 8);
+        if (committed < trace::header_size || committed > bytes.size())
+            throw std::invalid_argument("invalid trace file " + path);
+        bytes.resize(static_cast<size_t>(committed)); // we ignore the uncommitted bytes..
+    }
+
+    PLEXA_EXPORT size_t trace_replayer::replay(const size_t &max_ticks)
+    {
+        if (!exec.is_running())
+            exec.start_execution();
+
+        const uint8_t *end = nullptr; // the end of the current record..
+        const auto require = [&end](const uint8_t *data, const uint64_t &size)
+        { // we never read beyond the end of the current record..
+            if (static_cast<uint64_t>(end - data) < size)
+                throw std::invalid_argument("truncated trace record..");
+        };
+        const auto read_u32 = [&require](const uint8_t *&data)
+        {
+            require(data, 4);
+            const auto val = trace::load_u32(data);
+            data += 4;
+            return val;
+        };
+        const auto read_u64 = [&require](const uint8_t *&data)
+        {
+            require(data, 8);
+            const auto val = trace::load_u64(data);
+            data += 8;
+            return val;
+        };
+        const auto read_count = [&require, &read_u32](const uint8_t *&data, const uint64_t &min_size)
+        { // the number of elements, each taking at least `min_size` bytes, which must fit into the record..
+            const auto n = read_u32(data);
+            require(data, n * min_size);
+            return n;
+        };
+        const auto read_rational = [&read_u64](const uint8_t *&data)
+        {
+            const auto num = static_cast<int64_t>(read_u64(data));
+            const auto den = static_cast<int64_t>(read_u64(data));
+            if (den <= 0)
+                throw std::invalid_argument("invalid rational in the trace..");
+            return utils::rational(num, den);
+        };
+        const auto read_string = [&require, &read_u32](const uint8_t *&data)
+        {
+            const auto length = read_u32(data);
+            require(data, length);
+            std::string str(reinterpret_cast<const char *>(data), length);
+            data += length;
+            return str;
+        };
+
+        size_t ticks = 0;
+        while (ticks < max_ticks && pos + trace::record_header_size <= bytes.size())
+        {
+            const auto type = static_cast<trace::record_type>(bytes[pos]);
+            const auto length = trace::load_u32(bytes.data() + pos + 1);
+            const uint8_t *data = bytes.data() + pos + trace::record_header_size;
+            if (pos + trace::record_header_size + length > bytes.size())
+                throw std::invalid_argument("truncated trace record..");
+            end = data + length;
+            pos += trace::record_header_size + length;
+
+            switch (type)
+            {
+            case trace::Tick:
+            {
+                // we jump over the idle ticks, as the recorded executor did..
+                const auto ticks_to_go = (read_rational(data) - exec.get_current_time()) / exec.get_units_per_tick();
+                const size_t n = ticks_to_go.numerator() > 0 ? static_cast<size_t>((ticks_to_go.numerator() + ticks_to_go.denominator() - 1) / ticks_to_go.denominator()) : 1;
+                replayed_starts.clear();
+                replayed_ends.clear();
+                exec.tick(n);
+                ++ticks;
+
+                std::sort(recorded_starts.begin(), recorded_starts.end());
+                std::sort(recorded_ends.begin(), recorded_ends.end());
+                std::sort(replayed_starts.begin(), replayed_starts.end());
+                std::sort(replayed_ends.begin(), replayed_ends.end());
+                if (recorded_starts != replayed_starts || recorded_ends != replayed_ends)
+                    ++divergences;
+                recorded_starts.clear();
+                recorded_ends.clear();
+                start_delays.clear();
+                end_delays.clear();
+                break;
+            }
+            case trace::Start:
+            case trace::End:
+            {
+                auto &recorded = type == trace::Start ? recorded_starts : recorded_ends;
+                for (auto n = read_count(data, 8); n; --n)
+                    recorded.push_back(read_u64(data));
+                break;
+            }
+            case trace::StartDelay:
+            case trace::EndDelay:
+            {
+                auto &delays = type == trace::StartDelay ? start_delays : end_delays;
+                for (auto n = read_count(data, 24); n; --n)
+                {
+                    const auto id = read_u64(data);
+                    delays[id] = read_rational(data);
+                }
+                break;
+            }
+            case trace::Failure:
+            {
+                std::unordered_set<const ratio::atom *> failed;
+                for (auto n = read_count(data, 8); n; --n)
+                    failed.insert(&get_atom(read_u64(data)));
+                exec.failure(failed);
+                break;
+            }
+            case trace::AdaptScript:
+                exec.adapt(read_string(data));
+                break;
+            case trace::AdaptFiles:
+            {
+                std::vector<std::string> files(read_count(data, 4));
+                for (auto &f : files)
+                    f = read_string(data);
+                exec.adapt(files);
+                break;
+            }
+            case trace::Checkpoint:
+                break;
+            default:
+                throw std::invalid_argument("invalid trace record..");
+            }
+        }
+        return ticks;
+    }
+
+    void trace_replayer::starting(const std::unordered_set<ratio::atom *> &c_atoms)
+    {
+        std::unordered_map<const ratio::atom *, utils::rational> delays;
+        for (const auto &atm : c_atoms)
+        {
+            const auto id = variable(atm->get_sigma());
+            atoms[id] = atm;
+            if (auto dl = start_delays.find(id); dl != start_delays.cend())
+                delays.emplace(atm, dl->second);
+        }
+        if (!delays.empty())
+            exec.dont_start_yet(delays);
+    }
+    void trace_replayer::start(const std::unordered_set<ratio::atom *> &c_atoms)
+    {
+        for (const auto &atm : c_atoms)
+            replayed_starts.push_back(variable(atm->get_sigma()));
+    }
+    void trace_replayer::ending(const std::unordered_set<ratio::atom *> &c_atoms)
+    {
+        std::unordered_map<const ratio::atom *, utils::rational> delays;
+        for (const auto &atm : c_atoms)
+        {
+            const auto id = variable(atm->get_sigma());
+            atoms[id] = atm;
+            if (auto dl = end_delays.find(id); dl != end_delays.cend())
+                delays.emplace(atm, dl->second);
+        }
+        if (!delays.empty())
+            exec.dont_end_yet(delays);
+    }
+    void trace_replayer::end(const std::unordered_set<ratio::atom *> &c_atoms)
+    {
+        for (const auto &atm : c_atoms)
+            replayed_ends.push_back(variable(atm->get_sigma()));
+    }
+
+    const ratio::atom &trace_replayer::get_atom(const uint64_t &id) const
+    {
+        if (auto atm = atoms.find(id); atm != atoms.cend())
+            return *atm->second;
+        throw std::invalid_argument("unknown atom " + std::to_string(id) + " in the trace..");
+    }
+} // namespace ratio::executor
@@ -0,0 +1,109 @@
+#include "binary_writer.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    size_t failures = 0;
+
+    void check(const bool &cond, const std::string &what)
+    {
+        if (!cond)
+        {
+            std::cerr << "failed: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    /**
+     * @brief Decodes the given message, checking that it is consumed whole and that none of its prefixes is decoded.
+     */
+    ratio::executor::wire::event round_trip(const std::vector<uint8_t> &msg, const std::string &what)
+    {
+        ratio::executor::wire::event evt;
+        for (size_t size = 0; size < msg.size(); ++size)
+            check(ratio::executor::wire::decode(msg.data(), size, evt) == 0, what + ": truncated message decoded");
+        check(ratio::executor::wire::decode(msg.data(), msg.size(), evt) == msg.size(), what + ": message not consumed whole");
+        return evt;
+    }
+
+    /**
+     * @brief Checks that the message made of the given type and payload is rejected.
+     */
+    void check_rejected(const ratio::executor::wire::message_type &type, const std::vector<uint8_t> &payload, const std::string &what)
+    {
+        std::vector<uint8_t> msg = {ratio::executor::wire::magic, ratio::executor::wire::version, type, 0, static_cast<uint8_t>(payload.size()), 0, 0, 0};
+        msg.insert(msg.end(), payload.cbegin(), payload.cend());
+        ratio::executor::wire::event evt;
+        try
+        {
+            ratio::executor::wire::decode(msg.data(), msg.size(), evt);
+            check(false, what + ": invalid message decoded");
+        }
+        catch (const std::invalid_argument &)
+        { // the message has been rejected..
+        }
+    }
+} // namespace
+
+/**
+ * @brief Encodes each message type through the binary writer and decodes it back, checking the malformed payloads are rejected.
+ */
+int main()
+{
+    ratio::solver slv;
+    ratio::executor::executor exec(slv, "test");
+    slv.read("predicate Pulse() : Impulse {}\nfact p0 = new Pulse(at:1.0);\nfact p1 = new Pulse(at:2.0);\nfact p2 = new Pulse(at:30000.0);\n");
+    if (!slv.solve())
+    {
+        std::cerr << "the test problem is unsolvable.." << std::endl;
+        return 1;
+    }
+
+    std::unordered_set<ratio::atom *> atoms;
+    for (const auto &pred : slv.get_predicates())
+        for (const auto &atm : pred.get().get_instances())
+            atoms.insert(&static_cast<ratio::atom &>(*atm));
+    std::vector<uintptr_t> ids;
+    for (const auto &atm : atoms)
+        ids.push_back(ratio::get_id(*atm));
+    std::sort(ids.begin(), ids.end());
+
+    ratio::executor::binary_writer writer;
+    const auto solver_id = ratio::get_id(slv);
+
+    auto evt = round_trip(writer.executor_state_changed(exec), "state changed");
+    check(evt.type == ratio::executor::wire::StateChanged && evt.solver_id == solver_id && evt.state == exec.get_state(), "state changed: wrong event");
+
+    for (const auto &time : {utils::rational(0), utils::rational(7, 3), utils::rational(-7, 3), utils::rational(1ll << 40, 3)})
+    {
+        evt = round_trip(writer.tick(exec, time), "tick");
+        check(evt.type == ratio::executor::wire::Tick && evt.solver_id == solver_id && evt.num == static_cast<int64_t>(time.numerator()) && evt.den == static_cast<int64_t>(time.denominator()), "tick: wrong event");
+    }
+
+    evt = round_trip(writer.starting(exec, atoms), "starting");
+    check(evt.type == ratio::executor::wire::Starting && evt.solver_id == solver_id && evt.atoms == ids, "starting: wrong event");
+    evt = round_trip(writer.start(exec, atoms), "start");
+    check(evt.type == ratio::executor::wire::Start && evt.solver_id == solver_id && evt.atoms == ids, "start: wrong event");
+    evt = round_trip(writer.ending(exec, atoms), "ending");
+    check(evt.type == ratio::executor::wire::Ending && evt.solver_id == solver_id && evt.atoms == ids, "ending: wrong event");
+    evt = round_trip(writer.end(exec, {}), "end");
+    check(evt.type == ratio::executor::wire::End && evt.solver_id == solver_id && evt.atoms.empty(), "end: wrong event");
+
+    // the varints cut by the end of the payload..
+    check_rejected(ratio::executor::wire::Tick, {0x80}, "truncated solver id");
+    check_rejected(ratio::executor::wire::Tick, {0x01, 0x02, 0x81}, "truncated denominator");
+    check_rejected(ratio::executor::wire::Start, {0x01, 0x02, 0x01, 0xFF}, "truncated atom id");
+    // the varints longer than 64 bits..
+    check_rejected(ratio::executor::wire::Tick, {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x02, 0x00, 0x01}, "overlong solver id");
+    check_rejected(ratio::executor::wire::Tick, {0x01, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01, 0x01}, "overlong numerator");
+    // the other malformed payloads..
+    check_rejected(ratio::executor::wire::Tick, {0x01, 0x02, 0x00}, "zero denominator");
+    check_rejected(ratio::executor::wire::StateChanged, {0x01}, "missing state");
+    check_rejected(ratio::executor::wire::StateChanged, {0x01, 0xFF}, "invalid state");
+    check_rejected(ratio::executor::wire::Start, {0x01, 0x7F}, "too many atoms");
+    check_rejected(static_cast<ratio::executor::wire::message_type>(0x7F), {0x01}, "invalid type");
+
+    return failures ? 1 : 0;
+}